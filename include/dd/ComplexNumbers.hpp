@@ -10,20 +10,34 @@
 #include "ComplexCache.hpp"
 #include "ComplexTable.hpp"
 #include "ComplexValue.hpp"
+#include "ConcurrentComplexTable.hpp"
 #include "Definitions.hpp"
 
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <memory>
 
 namespace dd {
     struct ComplexNumbers {
-        ComplexTable<> complexTable{};
-        ComplexCache<> complexCache{};
+    private:
+        std::shared_ptr<ConcurrentComplexTable<>> table{std::make_shared<ConcurrentComplexTable<>>()};
+
+    public:
+        ConcurrentComplexTable<>& complexTable{*table};
+        ComplexCache<>            complexCache{};
 
         ComplexNumbers()  = default;
         ~ComplexNumbers() = default;
 
+        // use the complex table of `other`, e.g., in a package of another thread. The table may be used
+        // concurrently, whereas the cache for temporaries is owned by every instance and thereby by a single thread.
+        explicit ComplexNumbers(ComplexNumbers& other):
+            table(other.table), complexTable(*table) {}
+
+        ComplexNumbers(const ComplexNumbers&)            = delete;
+        ComplexNumbers& operator=(const ComplexNumbers&) = delete;
+
         void clear() {
             complexTable.clear();
             complexCache.clear();
@@ -163,8 +177,8 @@ namespace dd {
             if (signR) {
                 const auto absr = std::abs(r);
                 // if absolute value is close enough to zero, just return the zero entry (avoiding -0.0)
-                if (absr < decltype(complexTable)::tolerance()) {
-                    ret.real = &decltype(complexTable)::zero;
+                if (absr < ComplexTable<>::tolerance()) {
+                    ret.real = &ComplexTable<>::zero;
                 } else {
                     ret.real = CTEntry::getNegativePointer(complexTable.lookup(absr));
                 }
@@ -176,8 +190,8 @@ namespace dd {
             if (signI) {
                 const auto absi = std::abs(i);
                 // if absolute value is close enough to zero, just return the zero entry (avoiding -0.0)
-                if (absi < decltype(complexTable)::tolerance()) {
-                    ret.img = &decltype(complexTable)::zero;
+                if (absi < ComplexTable<>::tolerance()) {
+                    ret.img = &ComplexTable<>::zero;
                 } else {
                     ret.img = CTEntry::getNegativePointer(complexTable.lookup(absi));
                 }
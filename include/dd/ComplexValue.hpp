@@ -40,6 +40,10 @@ namespace dd {
                    ComplexTable<>::Entry::approximatelyZero(i);
         }
 
+        [[nodiscard]] constexpr fp mag2() const {
+            return r * r + i * i;
+        }
+
         constexpr bool operator==(const ComplexValue& other) const {
             return r == other.r && i == other.i;
         }
@@ -237,6 +241,14 @@ namespace dd {
             i                = tempi;
             return *this;
         }
+        ComplexValue& operator/=(const ComplexValue& rhs) {
+            const auto denominator = rhs.mag2();
+            const auto tempr       = (this->r * rhs.r + this->i * rhs.i) / denominator;
+            const auto tempi       = (this->i * rhs.r - this->r * rhs.i) / denominator;
+            r                      = tempr;
+            i                      = tempi;
+            return *this;
+        }
         friend ComplexValue operator+(ComplexValue lhs, const ComplexValue& rhs) {
             lhs += rhs;
             return lhs;
@@ -245,6 +257,10 @@ namespace dd {
             lhs *= rhs;
             return lhs;
         }
+        friend ComplexValue operator/(ComplexValue lhs, const ComplexValue& rhs) {
+            lhs /= rhs;
+            return lhs;
+        }
     };
 
     inline std::ostream& operator<<(std::ostream& os, const ComplexValue& c) {
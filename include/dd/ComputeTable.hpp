@@ -79,6 +79,9 @@ namespace dd {
             lookups = 0;
         }
 
+        [[nodiscard]] std::size_t getHits() const { return hits; }
+        [[nodiscard]] std::size_t getLookups() const { return lookups; }
+
         [[nodiscard]] fp hitRatio() const { return static_cast<fp>(hits) / lookups; }
         std::ostream&    printStatistics(std::ostream& os = std::cout) {
             os << "hits: " << hits << ", looks: " << lookups << ", ratio: " << hitRatio() << std::endl;
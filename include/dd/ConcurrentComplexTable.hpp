@@ -0,0 +1,424 @@
+/*
+ * This file is part of the MQT DD Package which is released under the MIT license.
+ * See file README.md or go to https://www.cda.cit.tum.de/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_CONCURRENTCOMPLEXTABLE_HPP
+#define DD_PACKAGE_CONCURRENTCOMPLEXTABLE_HPP
+
+#include "ComplexTable.hpp"
+#include "Definitions.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dd {
+    /// Complex table that may be shared by several threads looking up numbers concurrently
+    /// The buckets are split into shards of consecutive buckets, each of which is guarded by a mutex of its own and
+    /// allocates the entries of its buckets. A lookup locks the (at most two) shards holding the buckets within
+    /// tolerance of the value, so equal values are deduplicated across threads without a global lock.
+    /// Entries are the ones of ComplexTable, i.e., the static zero, one and sqrt(2)/2 entries are shared.
+    /// clear() and garbageCollect() must not run concurrently with other calls.
+    /// \tparam NBUCKET number of hash buckets to use
+    /// \tparam INITIAL_ALLOCATION_SIZE number of entries initially allocated, distributed over the shards
+    /// \tparam GROWTH_FACTOR factor that the allocations' size grows over time
+    /// \tparam INITIAL_GC_LIMIT number of entries initially used as garbage collection threshold
+    /// \tparam NSHARDS number of shards the buckets are distributed over
+    template<std::size_t NBUCKET = 65537, std::size_t INITIAL_ALLOCATION_SIZE = 2048, std::size_t GROWTH_FACTOR = 2, std::size_t INITIAL_GC_LIMIT = 65536, std::size_t NSHARDS = 64>
+    class ConcurrentComplexTable {
+    public:
+        using Entry = ComplexTable<>::Entry;
+
+        ConcurrentComplexTable() {
+            // add 1/2 to the complex table and increase its ref count (so that it is not collected)
+            lookup(0.5)->refCount++;
+        }
+
+        ~ConcurrentComplexTable() = default;
+
+        ConcurrentComplexTable(const ConcurrentComplexTable&)            = delete;
+        ConcurrentComplexTable& operator=(const ConcurrentComplexTable&) = delete;
+
+        static fp tolerance() {
+            return ComplexTable<>::tolerance();
+        }
+
+        static constexpr std::int64_t MASK = NBUCKET - 1;
+
+        // linear (clipped) hash function
+        static constexpr std::int64_t hash(const fp val) {
+            assert(val >= 0);
+            auto key = static_cast<std::int64_t>(std::nearbyint(val * MASK));
+            return std::min<std::int64_t>(key, MASK);
+        }
+
+        // access functions
+        [[nodiscard]] std::size_t getCount() const { return sum(&Shard::count); }
+
+        // sum of the peak counts of the shards
+        [[nodiscard]] std::size_t getPeakCount() const { return sum(&Shard::peakCount); }
+
+        [[nodiscard]] std::size_t getAllocations() const { return sum(&Shard::allocations); }
+
+        [[nodiscard]] std::size_t getGrowthFactor() const { return GROWTH_FACTOR; }
+
+        Entry* lookup(const fp& val) {
+            assert(!std::isnan(val));
+            assert(val >= 0); // required anyway for the hash function
+
+            const auto lowerKey = static_cast<std::size_t>(hash(std::max<fp>(val - tolerance(), 0.)));
+            const auto upperKey = static_cast<std::size_t>(hash(val + tolerance()));
+            auto&      lower    = shards.at(shardIndex(lowerKey));
+            auto&      upper    = shards.at(shardIndex(upperKey));
+            increment(lower.lookups);
+
+            if (Entry::approximatelyZero(val)) {
+                increment(lower.hits);
+                return &ComplexTable<>::zero;
+            }
+
+            if (Entry::approximatelyOne(val)) {
+                increment(lower.hits);
+                return &ComplexTable<>::one;
+            }
+
+            if (Entry::approximatelyEquals(val, SQRT2_2)) {
+                increment(lower.hits);
+                return &ComplexTable<>::sqrt2_2;
+            }
+
+            assert(val - tolerance() >= 0); // should be handle above as special case
+
+            // shards are always locked in ascending order
+            const std::unique_lock<std::mutex> lowerLock(lower.mutex);
+            std::unique_lock<std::mutex>       upperLock{};
+            if (&upper != &lower) {
+                upperLock = std::unique_lock<std::mutex>(upper.mutex);
+            }
+
+            if (upperKey == lowerKey) {
+                increment(lower.findOrInserts);
+                return findOrInsert(lowerKey, val);
+            }
+
+            // code below is to properly handle border cases |----(-|-)----|
+            // in case a value close to a border is looked up,
+            // only the last entry in the lower bucket and the first entry in the upper bucket need to be checked
+
+            const auto key = static_cast<std::size_t>(hash(val));
+
+            Entry* pLower; // NOLINT(cppcoreguidelines-init-variables)
+            Entry* pUpper; // NOLINT(cppcoreguidelines-init-variables)
+            if (lowerKey != key) {
+                pLower = tailTable[lowerKey];
+                pUpper = table[key];
+                increment(lower.lowerNeighbors);
+            } else {
+                pLower = tailTable[key];
+                pUpper = table[upperKey];
+                increment(lower.upperNeighbors);
+            }
+
+            bool lowerMatchFound = (pLower != nullptr && Entry::approximatelyEquals(val, pLower->value));
+            bool upperMatchFound = (pUpper != nullptr && Entry::approximatelyEquals(val, pUpper->value));
+
+            if (lowerMatchFound && upperMatchFound) {
+                increment(lower.hits);
+                const auto diffToLower = std::abs(pLower->value - val);
+                const auto diffToUpper = std::abs(pUpper->value - val);
+                // val is actually closer to p_lower than to p_upper
+                if (diffToLower < diffToUpper) {
+                    return pLower;
+                }
+                return pUpper;
+            }
+
+            if (lowerMatchFound) {
+                increment(lower.hits);
+                return pLower;
+            }
+
+            if (upperMatchFound) {
+                increment(lower.hits);
+                return pUpper;
+            }
+
+            // value was not found in the table -> get a new entry and add it to the central bucket
+            return insert(key, val);
+        }
+
+        [[nodiscard]] bool possiblyNeedsCollection() const { return getCount() >= gcLimit; }
+
+        std::size_t garbageCollect(bool force = false) {
+            gcCalls++;
+            // nothing to be done if garbage collection is not forced, and the limit has not been reached,
+            // or the current count is minimal (the complex table always contains at least 0.5)
+            const auto count = getCount();
+            if ((!force && count < gcLimit) || count <= 1) {
+                return 0;
+            }
+
+            gcRuns++;
+            std::size_t collected = 0;
+            std::size_t remaining = 0;
+            for (std::size_t key = 0; key < table.size(); ++key) {
+                auto&  shard = shards.at(shardIndex(key));
+                Entry* p     = table[key];
+                Entry* lastp = nullptr;
+                while (p != nullptr) {
+                    if (p->refCount == 0) {
+                        Entry* next = p->next;
+                        if (lastp == nullptr) {
+                            table[key] = next;
+                        } else {
+                            lastp->next = next;
+                        }
+                        returnEntry(shard, p);
+                        p = next;
+                        collected++;
+                    } else {
+                        lastp = p;
+                        p     = p->next;
+                        remaining++;
+                    }
+                    tailTable[key] = lastp;
+                }
+            }
+            // see ComplexTable::garbageCollect
+            if (remaining > gcLimit / 10 * 9) {
+                gcLimit = remaining + INITIAL_GC_LIMIT;
+            } else if (remaining < gcLimit / 128) {
+                gcLimit /= 2;
+            }
+            return collected;
+        }
+
+        void clear() {
+            // clear table buckets
+            table.fill(nullptr);
+            tailTable.fill(nullptr);
+
+            for (auto& shard: shards) {
+                shard.available = nullptr;
+                shard.chunks.clear();
+                shard.chunkIt        = {};
+                shard.chunkEndIt     = {};
+                shard.allocationSize = SHARD_ALLOCATION_SIZE;
+                shard.allocations    = 0;
+                shard.count          = 0;
+                shard.peakCount      = 0;
+                for (auto* counter: {&shard.collisions, &shard.insertCollisions, &shard.hits, &shard.findOrInserts,
+                                     &shard.lookups, &shard.inserts, &shard.lowerNeighbors, &shard.upperNeighbors}) {
+                    counter->store(0, std::memory_order_relaxed);
+                }
+            }
+
+            gcCalls = 0;
+            gcRuns  = 0;
+            gcLimit = INITIAL_GC_LIMIT;
+        }
+
+        [[nodiscard]] fp hitRatio() const { return static_cast<fp>(sum(&Shard::hits)) / sum(&Shard::lookups); }
+
+        [[nodiscard]] fp colRatio() const { return static_cast<fp>(sum(&Shard::collisions)) / sum(&Shard::lookups); }
+
+        std::map<std::string, std::size_t> getStatistics() const {
+            return {
+                    {"hits", sum(&Shard::hits)},
+                    {"collisions", sum(&Shard::collisions)},
+                    {"lookups", sum(&Shard::lookups)},
+                    {"inserts", sum(&Shard::inserts)},
+                    {"insertCollisions", sum(&Shard::insertCollisions)},
+                    {"findOrInserts", sum(&Shard::findOrInserts)},
+                    {"upperNeighbors", sum(&Shard::upperNeighbors)},
+                    {"lowerNeighbors", sum(&Shard::lowerNeighbors)},
+                    {"gcCalls", gcCalls},
+                    {"gcRuns", gcRuns},
+            };
+        }
+
+        std::ostream& printStatistics(std::ostream& os = std::cout) const {
+            for (const auto& [name, value]: getStatistics()) {
+                os << name << ": " << value << ", ";
+            }
+            os << "hitRatio: " << hitRatio() << ", colRatio: " << colRatio() << "\n";
+            return os;
+        }
+
+    private:
+        using Bucket = Entry*;
+        using Table  = std::array<Bucket, NBUCKET>;
+
+        static constexpr std::size_t SHARD_ALLOCATION_SIZE = std::max<std::size_t>(INITIAL_ALLOCATION_SIZE / NSHARDS, 16U);
+
+        // buckets [key * NSHARDS / NBUCKET == index] and the entries stored in them
+        struct alignas(64) Shard {
+            std::mutex mutex{};
+
+            Entry*                                available{};
+            std::vector<std::vector<Entry>>       chunks{};
+            typename std::vector<Entry>::iterator chunkIt{};
+            typename std::vector<Entry>::iterator chunkEndIt{};
+            std::size_t                           allocationSize{SHARD_ALLOCATION_SIZE};
+
+            // guarded by the mutex, read without it only for statistics
+            std::atomic<std::size_t> allocations{0};
+            std::atomic<std::size_t> count{0};
+            std::atomic<std::size_t> peakCount{0};
+
+            // table lookup statistics of lookups starting in this shard
+            std::atomic<std::size_t> collisions{0};
+            std::atomic<std::size_t> insertCollisions{0};
+            std::atomic<std::size_t> hits{0};
+            std::atomic<std::size_t> findOrInserts{0};
+            std::atomic<std::size_t> lookups{0};
+            std::atomic<std::size_t> inserts{0};
+            std::atomic<std::size_t> lowerNeighbors{0};
+            std::atomic<std::size_t> upperNeighbors{0};
+        };
+
+        Table table{};
+        Table tailTable{};
+
+        std::array<Shard, NSHARDS> shards{};
+
+        // garbage collection
+        std::size_t gcCalls = 0;
+        std::size_t gcRuns  = 0;
+        std::size_t gcLimit = INITIAL_GC_LIMIT;
+
+        static constexpr std::size_t shardIndex(const std::size_t key) {
+            return key * NSHARDS / NBUCKET;
+        }
+
+        static void increment(std::atomic<std::size_t>& counter) {
+            counter.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::size_t sum(std::atomic<std::size_t> Shard::*counter) const {
+            std::size_t total = 0;
+            for (const auto& shard: shards) {
+                total += (shard.*counter).load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        // the shard has to be locked by the caller
+        Entry* getEntry(Shard& shard) {
+            // an entry is available on the stack
+            if (shard.available != nullptr) {
+                Entry* entry    = shard.available;
+                shard.available = entry->next;
+                // returned entries could have a ref count != 0
+                entry->refCount = 0;
+                return entry;
+            }
+
+            // new chunk has to be allocated
+            if (shard.chunkIt == shard.chunkEndIt) {
+                shard.chunks.emplace_back(shard.allocationSize);
+                shard.allocations.fetch_add(shard.allocationSize, std::memory_order_relaxed);
+                shard.allocationSize *= GROWTH_FACTOR;
+                shard.chunkIt    = shard.chunks.back().begin();
+                shard.chunkEndIt = shard.chunks.back().end();
+            }
+
+            auto entry = &(*shard.chunkIt);
+            ++shard.chunkIt;
+            return entry;
+        }
+
+        static void returnEntry(Shard& shard, Entry* entry) {
+            entry->next     = shard.available;
+            shard.available = entry;
+            shard.count.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // link a new entry for val between prev and curr of the bucket indexed by key
+        Entry* link(const std::size_t key, const fp val, Entry* prev, Entry* curr) {
+            auto&  shard = shards.at(shardIndex(key));
+            Entry* entry = getEntry(shard);
+            entry->value = val;
+
+            if (prev == nullptr) {
+                // table bucket is empty
+                table[key] = entry;
+            } else {
+                prev->next = entry;
+            }
+            entry->next = curr;
+            if (curr == nullptr) {
+                tailTable[key] = entry;
+            }
+            const auto count = shard.count.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (count > shard.peakCount.load(std::memory_order_relaxed)) {
+                shard.peakCount.store(count, std::memory_order_relaxed);
+            }
+            return entry;
+        }
+
+        // see ComplexTable::findOrInsert
+        Entry* findOrInsert(const std::size_t key, const fp val) {
+            auto&    shard  = shards.at(shardIndex(key));
+            const fp valTol = val + tolerance();
+            Entry*   curr   = table[key];
+            Entry*   prev   = nullptr;
+
+            while (curr != nullptr && curr->value <= valTol) {
+                if (Entry::approximatelyEquals(curr->value, val)) {
+                    // check if val is actually closer to the next element in the list (if there is one)
+                    if (curr->next != nullptr) {
+                        const auto& next = curr->next;
+                        // potential candidate in range
+                        if (valTol >= next->value) {
+                            const auto diffToCurr = std::abs(curr->value - val);
+                            const auto diffToNext = std::abs(next->value - val);
+                            // val is actually closer to next than to curr
+                            if (diffToNext < diffToCurr) {
+                                increment(shard.hits);
+                                return next;
+                            }
+                        }
+                    }
+                    increment(shard.hits);
+                    return curr;
+                }
+                increment(shard.collisions);
+                prev = curr;
+                curr = curr->next;
+            }
+
+            increment(shard.inserts);
+            return link(key, val, prev, curr);
+        }
+
+        // see ComplexTable::insert
+        Entry* insert(const std::size_t key, const fp val) {
+            auto& shard = shards.at(shardIndex(key));
+            increment(shard.inserts);
+
+            Entry* curr = table[key];
+            Entry* prev = nullptr;
+
+            while (curr != nullptr && curr->value <= val) {
+                increment(shard.insertCollisions);
+                prev = curr;
+                curr = curr->next;
+            }
+            return link(key, val, prev, curr);
+        }
+    };
+} // namespace dd
+
+#endif //DD_PACKAGE_CONCURRENTCOMPLEXTABLE_HPP
@@ -0,0 +1,291 @@
+/*
+ * This file is part of the MQT DD Package which is released under the MIT license.
+ * See file README.md or go to https://www.cda.cit.tum.de/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_CONCURRENTUNIQUETABLE_HPP
+#define DD_PACKAGE_CONCURRENTUNIQUETABLE_HPP
+
+#include "ComplexNumbers.hpp"
+#include "Definitions.hpp"
+#include "Edge.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dd {
+
+    /// Unique table that may be shared by several threads creating DD nodes concurrently
+    /// Buckets are singly linked lists whose heads are replaced by compare-and-swap, i.e., lookups never block.
+    /// Nodes are allocated from slabs owned by the allocating thread and statistics are counted in per-thread
+    /// shards. Nodes are never collected, resize() and clear() must not run concurrently with other calls.
+    /// \tparam Node class of nodes to provide/store
+    /// \tparam NBUCKET number of hash buckets to use (has to be a power of two)
+    /// \tparam INITIAL_ALLOCATION_SIZE number of nodes initially allocated by every thread
+    /// \tparam GROWTH_FACTOR factor that the allocations' size grows over time
+    /// \tparam NSHARDS number of shards the statistics are distributed over
+    template<class Node, std::size_t NBUCKET = 32768, std::size_t INITIAL_ALLOCATION_SIZE = 2048, std::size_t GROWTH_FACTOR = 2, std::size_t NSHARDS = 64>
+    class ConcurrentUniqueTable {
+    public:
+        explicit ConcurrentUniqueTable(std::size_t nq) {
+            resize(nq);
+        }
+
+        ~ConcurrentUniqueTable() = default;
+
+        ConcurrentUniqueTable(const ConcurrentUniqueTable&)            = delete;
+        ConcurrentUniqueTable& operator=(const ConcurrentUniqueTable&) = delete;
+
+        static constexpr std::size_t MASK = NBUCKET - 1;
+
+        void resize(std::size_t nq) {
+            nvars = nq;
+            tables.resize(nq);
+            for (auto& table: tables) {
+                if (table == nullptr) {
+                    table = std::make_unique<Table>();
+                    for (auto& bucket: *table) {
+                        bucket.store(nullptr, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+
+        static std::size_t hash(const Node* p) {
+            std::size_t key = 0;
+            for (std::size_t i = 0; i < p->edges.size(); ++i) {
+                key = dd::combineHash(key, std::hash<Edge<Node>>{}(p->edges.at(i)));
+            }
+            key &= MASK;
+            return key;
+        }
+
+        // access functions
+        [[nodiscard]] std::size_t getNodeCount() const { return sum(&Statistics::nodeCount); }
+
+        // nodes are never collected, so the table never held more nodes than it does now
+        [[nodiscard]] std::size_t getPeakNodeCount() const { return getNodeCount(); }
+
+        [[nodiscard]] std::size_t getAllocations() const {
+            const std::lock_guard<std::mutex> lock(slabMutex);
+            std::size_t                       allocations = 0;
+            for (const auto& slab: slabs) {
+                allocations += slab.allocations;
+            }
+            return allocations;
+        }
+
+        [[nodiscard]] float getGrowthFactor() const { return GROWTH_FACTOR; }
+
+        // lookup a node in the unique table for the appropriate variable; insert it, if it has not been found.
+        // `initialize` is called on a node before it becomes visible to other threads, it might be called for
+        // nodes that are discarded because another thread inserted an equal node in the meantime.
+        // NOTE: only normalized nodes shall be stored.
+        template<class Initializer>
+        Edge<Node> lookup(const Edge<Node>& e, bool keepNode, Initializer&& initialize) {
+            // there are unique terminal nodes
+            if (e.isTerminal()) {
+                return e;
+            }
+
+            auto& statistics = localSlab().statistics;
+            statistics.lookups.fetch_add(1, std::memory_order_relaxed);
+            const auto key = hash(e.nextNode);
+            const auto v   = e.nextNode->varIndx;
+
+            // successors of a node shall either have successive variable numbers
+            // or be terminals
+            for ([[maybe_unused]] const auto& edge: e.nextNode->edges) {
+                assert(edge.nextNode->varIndx == v - 1 || edge.isTerminal());
+            }
+
+            auto& bucket      = tables[static_cast<std::size_t>(v)]->at(key);
+            Node* head        = bucket.load(std::memory_order_acquire);
+            Node* scannedHead = nullptr; // the chain from here on has already been searched
+            bool  initialized = false;
+            while (true) {
+                for (Node* p = head; p != scannedHead; p = p->next) {
+                    if (e.nextNode->edges == p->edges) {
+                        // Match found
+                        if (e.nextNode != p && !keepNode) {
+                            // put node pointed to by e.p on available chain
+                            returnNode(e.nextNode);
+                        }
+                        statistics.hits.fetch_add(1, std::memory_order_relaxed);
+
+                        // variables should stay the same
+                        assert(p->varIndx == e.nextNode->varIndx);
+
+                        return {p, e.weight};
+                    }
+                    statistics.collisions.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                if (!initialized) {
+                    initialize(e.nextNode);
+                    initialized = true;
+                }
+
+                // node was not found -> try to add it to front of unique table bucket. Published nodes are never
+                // modified, so on failure only the nodes inserted in the meantime have to be searched.
+                e.nextNode->next = head;
+                if (bucket.compare_exchange_weak(head, e.nextNode, std::memory_order_release, std::memory_order_acquire)) {
+                    statistics.nodeCount.fetch_add(1, std::memory_order_relaxed);
+                    return e;
+                }
+                scannedHead = e.nextNode->next;
+            }
+        }
+
+        Edge<Node> lookup(const Edge<Node>& e, bool keepNode = false) {
+            return lookup(e, keepNode, [](Node*) {});
+        }
+
+        [[nodiscard]] Node* getNode() {
+            auto& slab = localSlab();
+
+            // a node is available on the stack
+            if (slab.available != nullptr) {
+                Node* p        = slab.available;
+                slab.available = p->next;
+                // returned nodes could have a ref count != 0
+                p->refCount = 0;
+                return p;
+            }
+
+            // new chunk has to be allocated
+            if (slab.chunkIt == slab.chunkEndIt) {
+                slab.chunks.emplace_back(slab.allocationSize);
+                slab.allocations += slab.allocationSize;
+                slab.allocationSize *= GROWTH_FACTOR;
+                slab.chunkIt    = slab.chunks.back().begin();
+                slab.chunkEndIt = slab.chunks.back().end();
+            }
+
+            auto p = &(*slab.chunkIt);
+            ++slab.chunkIt;
+            return p;
+        }
+
+        // return an unused node to the slab of the calling thread
+        void returnNode(Node* p) {
+            auto& slab     = localSlab();
+            p->next        = slab.available;
+            slab.available = p;
+        }
+
+        void clear() {
+            for (auto& table: tables) {
+                for (auto& bucket: *table) {
+                    bucket.store(nullptr, std::memory_order_relaxed);
+                }
+            }
+            for (auto& shard: shards) {
+                shard.nodeCount.store(0, std::memory_order_relaxed);
+                shard.collisions.store(0, std::memory_order_relaxed);
+                shard.hits.store(0, std::memory_order_relaxed);
+                shard.lookups.store(0, std::memory_order_relaxed);
+            }
+            const std::lock_guard<std::mutex> lock(slabMutex);
+            slabs.clear();
+            // slabs cached by threads are invalidated by the new generation
+            generation = nextGeneration().fetch_add(1, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] fp hitRatio() const { return static_cast<fp>(sum(&Statistics::hits)) / sum(&Statistics::lookups); }
+
+        [[nodiscard]] fp colRatio() const { return static_cast<fp>(sum(&Statistics::collisions)) / sum(&Statistics::lookups); }
+
+        std::ostream& printStatistics(std::ostream& os = std::cout) {
+            os << "hits: " << sum(&Statistics::hits) << ", collisions: " << sum(&Statistics::collisions)
+               << ", looks: " << sum(&Statistics::lookups) << ", hitRatio: " << hitRatio()
+               << ", colRatio: " << colRatio() << ", threads: " << threads() << "\n";
+            return os;
+        }
+
+        // number of threads that allocated nodes from this table
+        [[nodiscard]] std::size_t threads() const {
+            const std::lock_guard<std::mutex> lock(slabMutex);
+            return slabs.size();
+        }
+
+    private:
+        using NodeBucket = std::atomic<Node*>;
+        using Table      = std::array<NodeBucket, NBUCKET>;
+
+        // counters of a shard, aligned to avoid false sharing between threads
+        struct alignas(64) Statistics {
+            std::atomic<std::size_t> nodeCount{0};
+            std::atomic<std::size_t> collisions{0};
+            std::atomic<std::size_t> hits{0};
+            std::atomic<std::size_t> lookups{0};
+        };
+
+        // nodes allocated by a single thread
+        struct Slab {
+            Slab(std::thread::id thread, Statistics& shard):
+                owner(thread), statistics(shard) {}
+
+            std::thread::id                      owner;
+
+            Node*                                available{};
+            std::vector<std::vector<Node>>       chunks{};
+            typename std::vector<Node>::iterator chunkIt{};
+            typename std::vector<Node>::iterator chunkEndIt{};
+            std::size_t                          allocationSize{INITIAL_ALLOCATION_SIZE};
+            std::size_t                          allocations = 0;
+            Statistics&                          statistics;
+        };
+
+        // unique tables (one per input variable)
+        std::size_t                         nvars = 0;
+        std::vector<std::unique_ptr<Table>> tables{};
+
+        mutable std::mutex               slabMutex{};
+        std::deque<Slab>                 slabs{};
+        std::array<Statistics, NSHARDS>  shards{};
+        std::size_t                      generation{nextGeneration().fetch_add(1, std::memory_order_relaxed)};
+
+        static std::atomic<std::size_t>& nextGeneration() {
+            static std::atomic<std::size_t> counter{0};
+            return counter;
+        }
+
+        // the slab of the calling thread, created on its first use of this table. Only the slab of the table
+        // used last is cached by the thread, slabs of other tables are looked up by their owner.
+        Slab& localSlab() {
+            thread_local std::size_t lastGeneration = 0;
+            thread_local Slab*       lastSlab       = nullptr;
+
+            if (lastSlab != nullptr && lastGeneration == generation) {
+                return *lastSlab;
+            }
+            const auto                        thread = std::this_thread::get_id();
+            const std::lock_guard<std::mutex> lock(slabMutex);
+            const auto                        it = std::find_if(slabs.begin(), slabs.end(), [&thread](const Slab& slab) { return slab.owner == thread; });
+            lastSlab                             = it != slabs.end() ? &*it : &slabs.emplace_back(thread, shards.at(slabs.size() % NSHARDS));
+            lastGeneration                       = generation;
+            return *lastSlab;
+        }
+
+        std::size_t sum(std::atomic<std::size_t> Statistics::*counter) const {
+            std::size_t total = 0;
+            for (const auto& shard: shards) {
+                total += (shard.*counter).load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+    };
+
+} // namespace dd
+
+#endif //DD_PACKAGE_CONCURRENTUNIQUETABLE_HPP
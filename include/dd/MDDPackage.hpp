@@ -10,33 +10,45 @@
 #include "ComplexTable.hpp"
 #include "ComplexValue.hpp"
 #include "ComputeTable.hpp"
+#include "ConcurrentUniqueTable.hpp"
 #include "Control.hpp"
 #include "Definitions.hpp"
 #include "Edge.hpp"
 #include "GateMatrixDefinitions.hpp"
+#include "NoiseModel.hpp"
+#include "Operation.hpp"
+#include "SparseMatrix.hpp"
+#include "TernaryComputeTable.hpp"
+#include "ThreadPool.hpp"
 #include "UnaryComputeTable.hpp"
-#include "UniqueTable.hpp"
 
 #include <algorithm>
 #include <array>
 #include <bitset>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <complex>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
+#include <numeric>
 #include <queue>
 #include <random>
 #include <regex>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
@@ -67,6 +79,21 @@ namespace dd {
             resize(nqr);
         };
 
+        // tag selecting the constructor of a package sharing the tables of another one
+        struct SharedTables {};
+
+        // package for another thread that creates its nodes and complex numbers in the unique and complex tables
+        // of `parent`, such that DDs may be passed freely between both. Compute tables are not shared.
+        MDDPackage(MDDPackage& parent, SharedTables /*tag*/):
+            complexNumber(parent.complexNumber),
+            numberOfQuantumRegisters(parent.numberOfQuantumRegisters),
+            registersSizes(parent.registersSizes),
+            vUniqueTableStorage(parent.vUniqueTableStorage),
+            mUniqueTableStorage(parent.mUniqueTableStorage),
+            dUniqueTableStorage(parent.dUniqueTableStorage) {
+            resize(numberOfQuantumRegisters);
+        }
+
         ~MDDPackage() = default;
 
         MDDPackage(const MDDPackage& MDDPackage) = delete; // no copy constructor
@@ -89,9 +116,16 @@ namespace dd {
             numberOfQuantumRegisters = nq;
             vUniqueTable.resize(numberOfQuantumRegisters);
             mUniqueTable.resize(numberOfQuantumRegisters);
-            // dUniqueTable.resize(number_of_quantum_registers);
-            // stochasticNoiseOperationCache.resize(number_of_quantum_registers);
+            dUniqueTable.resize(numberOfQuantumRegisters);
+            stochasticNoiseOperationCache.resize(numberOfQuantumRegisters);
             idTable.resize(numberOfQuantumRegisters);
+
+            // new levels hold the logical register of the same index
+            const auto previousLevels = logicalRegisters.size();
+            logicalRegisters.resize(numberOfQuantumRegisters);
+            for (auto level = previousLevels; level < numberOfQuantumRegisters; ++level) {
+                logicalRegisters.at(level) = static_cast<QuantumRegister>(level);
+            }
         }
 
         // reset package state
@@ -120,6 +154,8 @@ namespace dd {
         // TODO THIS IS NOT CONST RIGHT?
         // from LSB TO MSB
         std::vector<size_t> registersSizes;
+        // logical register held by every level, from LSB to MSB. Changed by dynamic reordering only.
+        std::vector<QuantumRegister> logicalRegisters{};
 
         ///
         /// Vector nodes, edges and quantum states
@@ -134,6 +170,7 @@ namespace dd {
             QuantumRegister
                     varIndx{}; // variable index (nonterminal) value (-1 for terminal),
                                // index in the circuit endianness 0 from below
+            std::vector<std::uint16_t> nonZeroEdges{}; // ascending indices of the edges with nonzero weight
 
             static vNode            terminalNode;            // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
             constexpr static vNode* terminal{&terminalNode}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables,readability-identifier-naming)
@@ -233,9 +270,10 @@ namespace dd {
                 currentEdge.weight.real->value *= commonFactor;
                 currentEdge.weight.img->value *= commonFactor;
             } else {
-                auto realPart      = CTEntry::val(currentEdge.weight.real) * commonFactor;
-                auto imgPart       = CTEntry::val(currentEdge.weight.img) * commonFactor;
-                currentEdge.weight = complexNumber.lookup(realPart, imgPart);
+                const auto maxWeight = valueOf(currentEdge.weight) * valueOf(max.weight);
+                auto       realPart  = maxWeight.r * commonFactor;
+                auto       imgPart   = maxWeight.i * commonFactor;
+                currentEdge.weight   = complexNumber.lookup(realPart, imgPart);
                 if (currentEdge.weight.approximatelyZero()) {
                     return vEdge::zero;
                 }
@@ -317,6 +355,174 @@ namespace dd {
             return f;
         }
 
+        // generate the state of all registers given by its dense amplitude vector, indexed like getVector.
+        // Amplitudes with a magnitude below `tolerance` are pruned. With more than one thread, the subtrees below
+        // the top levels are built concurrently and deduplicated through the shared unique table.
+        vEdge makeStateFromVector(const CVec& amplitudes, std::size_t threads = 1, fp tolerance = ComplexTable<>::tolerance()) {
+            return makeStateFromVector(amplitudes.data(), amplitudes.size(), threads, tolerance);
+        }
+
+        vEdge makeStateFromVector(const std::complex<fp>* amplitudes, std::size_t size, std::size_t threads = 1,
+                                  fp tolerance = ComplexTable<>::tolerance()) {
+            const auto dim = stateDimension();
+            if (size != dim) {
+                throw std::invalid_argument("State vector has " + std::to_string(size) + " entries, but the state has " +
+                                            std::to_string(dim) + ".");
+            }
+            if (numberOfQuantumRegisters == 0) {
+                return std::abs(amplitudes[0]) < tolerance ? vEdge::zero : vEdge::terminal(complexNumber.lookup(amplitudes[0].real(), amplitudes[0].imag()));
+            }
+
+            // split off the top levels until there are enough blocks for the threads. The bottom level is never
+            // split off, so every block is built from at least one level.
+            auto        var    = static_cast<QuantumRegister>(numberOfQuantumRegisters - 1);
+            std::size_t blocks = 1;
+            std::size_t levels = 0;
+            while (threads > 1 && blocks < threads * 4 && var > 0) {
+                blocks *= registersSizes.at(static_cast<std::size_t>(var));
+                --var;
+                ++levels;
+            }
+            if (levels == 0) {
+                auto caches = makeBlockCaches<vNode>();
+                return makeStateBlock(amplitudes, static_cast<QuantumRegister>(numberOfQuantumRegisters - 1), dim, tolerance, caches);
+            }
+
+            // every block is a contiguous range of amplitudes, since the top levels are the most significant ones
+            const auto                      span = dim / blocks;
+            auto&                           pool = getThreadPool(threads);
+            std::vector<std::future<vEdge>> subtrees{};
+            subtrees.reserve(blocks);
+            for (std::size_t block = 0; block < blocks; ++block) {
+                subtrees.push_back(pool.submit([this, amplitudes, block, span, var, tolerance]() {
+                    auto& worker = *workerPackages.at(ThreadPool::currentWorker());
+                    auto  caches = worker.makeBlockCaches<vNode>();
+                    return worker.makeStateBlock(amplitudes + block * span, var, span, tolerance, caches);
+                }));
+            }
+            std::vector<vEdge> edges{};
+            edges.reserve(blocks);
+            for (auto& subtree: subtrees) {
+                edges.push_back(subtree.get());
+            }
+
+            // combine the subtrees level by level
+            for (auto level = static_cast<QuantumRegister>(var + 1); level < static_cast<QuantumRegister>(numberOfQuantumRegisters); ++level) {
+                const auto         basicDim = registersSizes.at(static_cast<std::size_t>(level));
+                std::vector<vEdge> parents{};
+                parents.reserve(edges.size() / basicDim);
+                for (auto first = edges.begin(); first != edges.end(); first += static_cast<std::ptrdiff_t>(basicDim)) {
+                    parents.push_back(makeBlockNode(level, std::vector<vEdge>(first, first + static_cast<std::ptrdiff_t>(basicDim))));
+                }
+                edges = std::move(parents);
+            }
+            assert(edges.size() == 1);
+            return edges.front();
+        }
+
+    private:
+        // direct-mapped cache of the blocks of one level that have been turned into DD nodes recently. Repeated
+        // blocks, e.g., of product states or of banded matrices, are neither normalized nor looked up in the tables
+        // again. Blocks of the bottom level are identified by their values, all others by their successors.
+        template<class Node>
+        struct BlockCache {
+            static constexpr std::size_t SLOTS = 256;
+
+            explicit BlockCache(std::size_t successors):
+                values(SLOTS * successors), edges(SLOTS * successors), results(SLOTS), valid(SLOTS, false),
+                scratchValues(successors), scratch(successors) {}
+
+            std::vector<std::complex<fp>> values; // keys of the bottom level
+            std::vector<Edge<Node>>       edges;  // keys of all other levels
+            std::vector<Edge<Node>>       results;
+            std::vector<bool>             valid;
+            std::vector<std::complex<fp>> scratchValues; // values of the bottom level block currently built
+            std::vector<Edge<Node>>       scratch;       // successors of the node currently built
+        };
+
+        template<class Node>
+        std::vector<BlockCache<Node>> makeBlockCaches() const {
+            std::vector<BlockCache<Node>> caches{};
+            caches.reserve(registersSizes.size());
+            for (const auto registersSize: registersSizes) {
+                caches.emplace_back(std::is_same_v<Node, vNode> ? registersSize : registersSize * registersSize);
+            }
+            return caches;
+        }
+
+        // node of the bottom level with the given values of its terminal successors
+        template<class Node>
+        Edge<Node> makeTerminalBlock(BlockCache<Node>& cache, const std::complex<fp>* values, fp tolerance) {
+            const auto  successors = cache.scratch.size();
+            std::size_t key        = 0;
+            for (std::size_t i = 0; i < successors; ++i) {
+                key = combineHash(combineHash(key, bitsOf(values[i].real())), bitsOf(values[i].imag()));
+            }
+            const auto slot = murmur64(key) % BlockCache<Node>::SLOTS;
+            const auto keys = cache.values.begin() + static_cast<std::ptrdiff_t>(slot * successors);
+            if (cache.valid[slot] && std::equal(values, values + successors, keys)) {
+                return cache.results[slot];
+            }
+            for (std::size_t i = 0; i < successors; ++i) {
+                cache.scratch[i] = std::abs(values[i]) < tolerance ? Edge<Node>::zero : Edge<Node>::terminal(complexNumber.lookup(values[i].real(), values[i].imag()));
+            }
+            std::copy(values, values + successors, keys);
+            cache.valid[slot]   = true;
+            cache.results[slot] = makeBlockNode(0, cache.scratch);
+            return cache.results[slot];
+        }
+
+        // node of register `var` with the successors in the scratch space of the cache
+        template<class Node>
+        Edge<Node> makeInnerBlock(BlockCache<Node>& cache, QuantumRegister var) {
+            const auto& edges = cache.scratch;
+            std::size_t key   = 0;
+            for (const auto& edge: edges) {
+                key = combineHash(key, std::hash<Edge<Node>>{}(edge));
+            }
+            const auto slot = murmur64(key) % BlockCache<Node>::SLOTS;
+            const auto keys = cache.edges.begin() + static_cast<std::ptrdiff_t>(slot * edges.size());
+            if (cache.valid[slot] && std::equal(edges.begin(), edges.end(), keys)) {
+                return cache.results[slot];
+            }
+            std::copy(edges.begin(), edges.end(), keys);
+            cache.valid[slot]   = true;
+            cache.results[slot] = makeBlockNode(var, edges);
+            return cache.results[slot];
+        }
+
+        // build the DD of the `span` amplitudes represented by a node of register `var`
+        vEdge makeStateBlock(const std::complex<fp>* amplitudes, QuantumRegister var, std::size_t span, fp tolerance,
+                             std::vector<BlockCache<vNode>>& caches) {
+            auto& cache = caches.at(static_cast<std::size_t>(var));
+            if (var == 0) {
+                return makeTerminalBlock(cache, amplitudes, tolerance);
+            }
+            const auto childSpan = span / cache.scratch.size();
+            for (std::size_t i = 0; i < cache.scratch.size(); ++i) {
+                // the successors use the scratch space of the level below
+                cache.scratch[i] = makeStateBlock(amplitudes + i * childSpan, static_cast<QuantumRegister>(var - 1), childSpan, tolerance, caches);
+            }
+            return makeInnerBlock(cache, var);
+        }
+
+        static std::size_t bitsOf(fp value) {
+            static_assert(sizeof(fp) == sizeof(std::size_t));
+            std::size_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        // nodes without any nonzero successor are not created at all
+        template<class Node>
+        Edge<Node> makeBlockNode(QuantumRegister var, const std::vector<Edge<Node>>& edges) {
+            if (std::all_of(edges.begin(), edges.end(), [](const Edge<Node>& e) { return e.weight == Complex::zero; })) {
+                return Edge<Node>::zero;
+            }
+            return makeDDNode(var, edges);
+        }
+
+    public:
         // create a normalized DD node and return an edge pointing to it. The
         // node is not recreated if it already exists.
         template<class Node>
@@ -339,17 +545,24 @@ namespace dd {
             newEdge = normalize(newEdge, cached);
             assert(newEdge.nextNode->varIndx == varidx || newEdge.isTerminal());
 
-            // look it up in the unique tables
-            auto lookedUpEdge = uniqueTable.lookup(newEdge, false);
-            assert(lookedUpEdge.nextNode->varIndx == varidx ||
-                   lookedUpEdge.isTerminal());
+            // look it up in the unique tables. New nodes are completed before other threads can see them.
+            auto lookedUpEdge = uniqueTable.lookup(newEdge, false, [this](Node* node) {
+                // index the nonzero successors
+                assert(node->edges.size() <= std::numeric_limits<std::uint16_t>::max());
+                node->nonZeroEdges.clear();
+                for (auto i = 0U; i < node->edges.size(); ++i) {
+                    if (node->edges.at(i).weight != Complex::zero) {
+                        node->nonZeroEdges.push_back(static_cast<std::uint16_t>(i));
+                    }
+                }
 
-            // set specific node properties for matrices
-            if constexpr (std::is_same_v<Node, mNode>) {
-                if (lookedUpEdge.nextNode == newEdge.nextNode) {
-                    checkSpecialMatrices(lookedUpEdge.nextNode);
+                // set specific node properties for matrices
+                if constexpr (std::is_same_v<Node, mNode>) {
+                    checkSpecialMatrices(node);
                 }
-            }
+            });
+            assert(lookedUpEdge.nextNode->varIndx == varidx ||
+                   lookedUpEdge.isTerminal());
 
             return lookedUpEdge;
         }
@@ -362,8 +575,11 @@ namespace dd {
             RefCount                 refCount{}; // reference count
             QuantumRegister          varIndx{};  // variable index (nonterminal) value (-1
                                                  // for terminal)
-            bool symmetric = false;              // node is symmetric
-            bool identity  = false;              // node resembles identity
+            bool symmetric     = false;          // node is symmetric
+            bool identity      = false;          // node resembles identity
+            bool blockIdentity = false;          // node acts as identity on its level, i.e., all diagonal
+                                                 // successors are the same edge and all others are zero
+            std::vector<std::uint16_t> nonZeroEdges{}; // ascending indices of the edges with nonzero weight
 
             static mNode            terminalNode;            // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
             constexpr static mNode* terminal{&terminalNode}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables,readability-identifier-naming)
@@ -375,7 +591,28 @@ namespace dd {
         using mEdge       = Edge<mNode>;
         using mCachedEdge = CachedEdge<mNode>;
 
-        mEdge normalize(const mEdge& edge, bool cached) {
+        // density matrices have the layout of matrices but their own unique and compute tables
+        // NOLINTNEXTLINE(readability-identifier-naming)
+        struct dNode {
+            std::vector<Edge<dNode>>   edges{};        // edges out of this node, row major
+            dNode*                     next{};         // used to link nodes in unique table
+            RefCount                   refCount{};     // reference count
+            QuantumRegister            varIndx{};      // variable index (nonterminal) value (-1 for terminal)
+            std::vector<std::uint16_t> nonZeroEdges{}; // ascending indices of the edges with nonzero weight
+
+            static dNode            terminalNode;            // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+            constexpr static dNode* terminal{&terminalNode}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables,readability-identifier-naming)
+
+            static constexpr bool isTerminal(const dNode* nodePoint) {
+                return nodePoint == terminal;
+            }
+        };
+        using dEdge       = Edge<dNode>;
+        using dCachedEdge = CachedEdge<dNode>;
+
+        // matrices and density matrices are normalized alike
+        template<class Node>
+        Edge<Node> normalize(const Edge<Node>& edge, bool cached) {
             auto argmax = -1;
 
             std::vector<bool> zero;
@@ -392,7 +629,7 @@ namespace dd {
                         // TODO what is returnToCache
 
                         complexNumber.returnToCache(edge.nextNode->edges.at(i).weight);
-                        edge.nextNode->edges.at(i) = mEdge::zero;
+                        edge.nextNode->edges.at(i) = Edge<Node>::zero;
                     }
                 }
             }
@@ -424,9 +661,9 @@ namespace dd {
                 if (!cached && !edge.isTerminal()) {
                     // If it is not a cached computation, the node has to be put
                     // back into the chain
-                    mUniqueTable.returnNode(edge.nextNode);
+                    getUniqueTable<Node>().returnNode(edge.nextNode);
                 }
-                return mEdge::zero;
+                return Edge<Node>::zero;
             }
 
             auto currentEdge = edge;
@@ -470,6 +707,145 @@ namespace dd {
             return currentEdge;
         }
 
+        // generate the DD of an operator on all registers given by its dense row-major entries, indexed like
+        // getMatrix. Entries with a magnitude below `tolerance` are pruned.
+        mEdge makeDDFromMatrix(const std::complex<fp>* entries, std::size_t size, fp tolerance = ComplexTable<>::tolerance()) {
+            const auto dim = stateDimension();
+            if (size != checkedSquare(dim)) {
+                throw std::invalid_argument("Matrix has " + std::to_string(size) + " entries, but the operator has " +
+                                            std::to_string(checkedSquare(dim)) + ".");
+            }
+            auto caches = makeBlockCaches<mNode>();
+            return makeDenseMatrixBlock(entries, 0, 0, dim, dim, static_cast<QuantumRegister>(numberOfQuantumRegisters - 1), tolerance, caches);
+        }
+
+        // generate the DD of a sparse operator on all registers. The cost is proportional to the number of
+        // nonzero entries times the number of registers.
+        mEdge makeDDFromMatrix(const CSRMatrix& matrix, fp tolerance = ComplexTable<>::tolerance()) {
+            checkOperatorDimension(matrix.dimension);
+            matrix.validate();
+            std::vector<MatrixEntry> entries{};
+            entries.reserve(matrix.values.size());
+            for (std::size_t row = 0; row < matrix.dimension; ++row) {
+                for (auto k = matrix.rowPointers.at(row); k < matrix.rowPointers.at(row + 1); ++k) {
+                    entries.push_back({row, matrix.columnIndices.at(k), matrix.values.at(k)});
+                }
+            }
+            return makeSparseMatrix(entries, tolerance);
+        }
+
+        mEdge makeDDFromMatrix(const COOMatrix& matrix, fp tolerance = ComplexTable<>::tolerance()) {
+            checkOperatorDimension(matrix.dimension);
+            matrix.validate();
+            std::vector<MatrixEntry> entries{};
+            entries.reserve(matrix.values.size());
+            for (std::size_t k = 0; k < matrix.values.size(); ++k) {
+                entries.push_back({matrix.rows.at(k), matrix.columns.at(k), matrix.values.at(k)});
+            }
+            return makeSparseMatrix(entries, tolerance);
+        }
+
+    private:
+        struct MatrixEntry {
+            std::size_t      row;
+            std::size_t      col;
+            std::complex<fp> value;
+        };
+
+        void checkOperatorDimension(std::size_t dimension) const {
+            if (dimension != stateDimension()) {
+                throw std::invalid_argument("Matrix has dimension " + std::to_string(dimension) + ", but the operator has " +
+                                            std::to_string(stateDimension()) + ".");
+            }
+        }
+
+        mEdge makeSparseMatrix(std::vector<MatrixEntry>& entries, fp tolerance) {
+            std::vector<MatrixEntry> scratch(entries.size());
+            auto                     caches = makeBlockCaches<mNode>();
+            return makeSparseMatrixBlock(entries.data(), entries.data() + entries.size(), scratch.data(),
+                                         static_cast<QuantumRegister>(numberOfQuantumRegisters - 1), stateDimension(), tolerance, caches);
+        }
+
+        // build the DD of the `span` x `span` block holding the entries [first, last), whose indices are relative to
+        // the block. The entries are sorted into the successor blocks in `scratch`, which then serves as the entries
+        // of the successors while [first, last) becomes their scratch space.
+        mEdge makeSparseMatrixBlock(MatrixEntry* first, MatrixEntry* last, MatrixEntry* scratch, QuantumRegister var,
+                                    std::size_t span, fp tolerance, std::vector<BlockCache<mNode>>& caches) {
+            if (first == last) {
+                return mEdge::zero;
+            }
+            if (var < 0) {
+                std::complex<fp> value{0., 0.};
+                for (auto* entry = first; entry != last; ++entry) {
+                    value += entry->value;
+                }
+                return std::abs(value) < tolerance ? mEdge::zero : mEdge::terminal(complexNumber.lookup(value.real(), value.imag()));
+            }
+
+            auto&      cache     = caches.at(static_cast<std::size_t>(var));
+            const auto basicDim  = registersSizes.at(static_cast<std::size_t>(var));
+            const auto childSpan = span / basicDim;
+
+            // the successors are terminals, so the entries only have to be summed up
+            if (var == 0) {
+                auto& values = cache.scratchValues;
+                std::fill(values.begin(), values.end(), std::complex<fp>{0., 0.});
+                for (auto* entry = first; entry != last; ++entry) {
+                    values[entry->row * basicDim + entry->col] += entry->value;
+                }
+                return makeTerminalBlock(cache, values.data(), tolerance);
+            }
+
+            // counting sort by successor block
+            const auto blockOf = [basicDim, childSpan](const MatrixEntry& entry) {
+                return (entry.row / childSpan) * basicDim + entry.col / childSpan;
+            };
+            std::vector<std::size_t> bounds(basicDim * basicDim + 1, 0);
+            for (auto* entry = first; entry != last; ++entry) {
+                ++bounds[blockOf(*entry) + 1];
+            }
+            std::partial_sum(bounds.begin(), bounds.end(), bounds.begin());
+            auto positions = bounds;
+            for (auto* entry = first; entry != last; ++entry) {
+                scratch[positions[blockOf(*entry)]++] = {entry->row % childSpan, entry->col % childSpan, entry->value};
+            }
+
+            for (std::size_t k = 0; k < cache.scratch.size(); ++k) {
+                cache.scratch[k] = makeSparseMatrixBlock(scratch + bounds[k], scratch + bounds[k + 1], first + bounds[k],
+                                                         static_cast<QuantumRegister>(var - 1), childSpan, tolerance, caches);
+            }
+            return makeInnerBlock(cache, var);
+        }
+
+        // build the DD of the `span` x `span` block with top left corner (row, col) of a row-major matrix
+        mEdge makeDenseMatrixBlock(const std::complex<fp>* entries, std::size_t row, std::size_t col, std::size_t span,
+                                   std::size_t stride, QuantumRegister var, fp tolerance, std::vector<BlockCache<mNode>>& caches) {
+            if (var < 0) {
+                const auto& value = entries[row * stride + col];
+                return std::abs(value) < tolerance ? mEdge::zero : mEdge::terminal(complexNumber.lookup(value.real(), value.imag()));
+            }
+
+            auto&      cache     = caches.at(static_cast<std::size_t>(var));
+            const auto basicDim  = registersSizes.at(static_cast<std::size_t>(var));
+            const auto childSpan = span / basicDim;
+            if (var == 0) {
+                for (std::size_t i = 0; i < basicDim; ++i) {
+                    std::copy(entries + (row + i) * stride + col, entries + (row + i) * stride + col + basicDim,
+                              cache.scratchValues.begin() + static_cast<std::ptrdiff_t>(i * basicDim));
+                }
+                return makeTerminalBlock(cache, cache.scratchValues.data(), tolerance);
+            }
+
+            for (std::size_t i = 0; i < basicDim; ++i) {
+                for (std::size_t j = 0; j < basicDim; ++j) {
+                    cache.scratch[i * basicDim + j] = makeDenseMatrixBlock(entries, row + i * childSpan, col + j * childSpan, childSpan, stride,
+                                                                           static_cast<QuantumRegister>(var - 1), tolerance, caches);
+                }
+            }
+            return makeInnerBlock(cache, var);
+        }
+
+    public:
         /// Make GATE DD
         // SIZE => EDGE (number of successors)
         // build matrix representation for a single gate on an n-qubit circuit
@@ -515,37 +891,10 @@ namespace dd {
             auto currentReg = static_cast<QuantumRegister>(start);
             // process lines below target
             for (; currentReg < target; currentReg++) {
-                auto radix = registersSizes.at(static_cast<std::size_t>(currentReg));
-
                 for (auto rowMat = 0U; rowMat < targetRadix; ++rowMat) {
                     for (auto colMat = 0U; colMat < targetRadix; ++colMat) {
-                        auto entryPos = (rowMat * targetRadix) + colMat;
-
-                        std::vector<mEdge> quadEdges(radix * radix, mEdge::zero);
-
-                        if (currentControl != controls.end() && currentControl->quantumRegister == currentReg) {
-                            if (rowMat == colMat) {
-                                for (auto i = 0U; i < radix; i++) {
-                                    auto diagInd = i * radix + i;
-
-                                    if (i == currentControl->type) {
-                                        quadEdges.at(diagInd) = edgesMat.at(entryPos);
-                                    } else {
-                                        quadEdges.at(diagInd) = makeIdent(static_cast<QuantumRegister>(start), static_cast<QuantumRegister>(currentReg - 1));
-                                    }
-                                }
-                            } else {
-                                quadEdges.at(currentControl->type + radix * currentControl->type) = edgesMat.at(entryPos);
-                            }
-                            edgesMat.at(entryPos) = makeDDNode(currentReg, quadEdges);
-
-                        } else { // not connected
-
-                            for (auto iD = 0U; iD < radix; iD++) {
-                                quadEdges.at(iD * radix + iD) = edgesMat.at(entryPos);
-                            }
-                            edgesMat.at(entryPos) = makeDDNode(currentReg, quadEdges);
-                        }
+                        auto entryPos         = (rowMat * targetRadix) + colMat;
+                        edgesMat.at(entryPos) = extendGateBlock(edgesMat.at(entryPos), currentReg, rowMat == colMat, controls, currentControl, start);
                     }
                 }
 
@@ -561,32 +910,187 @@ namespace dd {
             // process lines above target
             for (; currentReg < static_cast<QuantumRegister>(n - 1 + start);
                  currentReg++) {
-                auto               nextReg   = static_cast<QuantumRegister>(currentReg + 1);
-                auto               nextRadix = registersSizes.at(static_cast<std::size_t>(nextReg));
-                std::vector<mEdge> nextEdges(nextRadix * nextRadix, mEdge::zero);
-
+                auto nextReg   = static_cast<QuantumRegister>(currentReg + 1);
+                targetNodeEdge = extendGateBlock(targetNodeEdge, nextReg, true, controls, currentControl, start);
                 if (currentControl != controls.end() && currentControl->quantumRegister == nextReg) {
-                    for (auto i = 0U; i < nextRadix; i++) {
-                        auto diagInd = i * nextRadix + i;
-                        if (i == currentControl->type) {
-                            nextEdges.at(diagInd) = targetNodeEdge;
-                        } else {
-                            nextEdges.at(diagInd) = makeIdent(static_cast<QuantumRegister>(start), static_cast<QuantumRegister>(nextReg - 1));
+                    ++currentControl;
+                }
+            }
+            return targetNodeEdge;
+        }
+
+        /// Make two-qudit GATE DD
+        // build matrix representation for a gate acting on two registers of an n-qudit circuit.
+        // The matrix is given in row-major order over the joint space of both targets with target0 as the
+        // more significant index, i.e., entry (i0 * d1 + i1, j0 * d1 + j1) maps |j0 j1> to |i0 i1>.
+
+        template<typename Matrix>
+        mEdge makeTwoQuditGateDD(const Matrix& mat, QuantumRegisterCount n,
+                                 QuantumRegister target0, QuantumRegister target1,
+                                 std::size_t start = 0) {
+            return makeTwoQuditGateDD(mat, n, Controls{}, target0, target1, start);
+        }
+
+        template<typename Matrix>
+        mEdge makeTwoQuditGateDD(const Matrix& mat, QuantumRegisterCount n,
+                                 const Controls& controls, QuantumRegister target0,
+                                 QuantumRegister target1, std::size_t start = 0) {
+            if (n + start > numberOfQuantumRegisters) {
+                throw std::runtime_error(
+                        "Requested gate with " + std::to_string(n + start) +
+                        " qubits, but current package configuration only supports up "
+                        "to " +
+                        std::to_string(numberOfQuantumRegisters) +
+                        " qubits. Please allocate a larger package instance.");
+            }
+            if (target0 == target1) {
+                throw std::invalid_argument("Two-qudit gate requires two distinct target registers.");
+            }
+            if (controls.count(target0) > 0 || controls.count(target1) > 0) {
+                throw std::invalid_argument("Target registers of a two-qudit gate must not be controls.");
+            }
+
+            const auto lowTarget  = std::min(target0, target1);
+            const auto highTarget = std::max(target0, target1);
+            const auto lowRadix   = registersSizes.at(static_cast<std::size_t>(lowTarget));
+            const auto highRadix  = registersSizes.at(static_cast<std::size_t>(highTarget));
+            const auto jointRadix = lowRadix * highRadix;
+
+            if (mat.size() != jointRadix * jointRadix) {
+                throw std::invalid_argument("Two-qudit gate matrix has " + std::to_string(mat.size()) +
+                                            " entries, but the target registers require " +
+                                            std::to_string(jointRadix * jointRadix) + ".");
+            }
+
+            // one block of low target entries for every entry of the high target
+            const auto         lowEntries = lowRadix * lowRadix;
+            std::vector<mEdge> edgesMat(lowEntries * highRadix * highRadix, mEdge::zero);
+
+            for (auto rowHigh = 0U; rowHigh < highRadix; ++rowHigh) {
+                for (auto colHigh = 0U; colHigh < highRadix; ++colHigh) {
+                    for (auto rowLow = 0U; rowLow < lowRadix; ++rowLow) {
+                        for (auto colLow = 0U; colLow < lowRadix; ++colLow) {
+                            const auto row    = (target0 == highTarget) ? rowHigh * lowRadix + rowLow : rowLow * highRadix + rowHigh;
+                            const auto col    = (target0 == highTarget) ? colHigh * lowRadix + colLow : colLow * highRadix + colHigh;
+                            const auto matIdx = row * jointRadix + col;
+
+                            if (mat.at(matIdx).r != 0 || mat.at(matIdx).i != 0) {
+                                const auto entryPos = (rowHigh * highRadix + colHigh) * lowEntries + rowLow * lowRadix + colLow;
+                                edgesMat.at(entryPos) = mEdge::terminal(complexNumber.lookup(mat.at(matIdx)));
+                            }
                         }
                     }
+                }
+            }
+
+            auto currentControl = controls.begin();
+            auto currentReg     = static_cast<QuantumRegister>(start);
+
+            // process lines below the lower target
+            for (; currentReg < lowTarget; currentReg++) {
+                for (auto entryPos = 0U; entryPos < edgesMat.size(); ++entryPos) {
+                    const auto highPos     = entryPos / lowEntries;
+                    const auto lowPos      = entryPos % lowEntries;
+                    const bool onDiagonal  = (highPos / highRadix == highPos % highRadix) && (lowPos / lowRadix == lowPos % lowRadix);
+                    edgesMat.at(entryPos) = extendGateBlock(edgesMat.at(entryPos), currentReg, onDiagonal, controls, currentControl, start);
+                }
+                if (currentControl != controls.end() && currentControl->quantumRegister == currentReg) {
+                    ++currentControl;
+                }
+            }
+
+            // lower target line
+            std::vector<mEdge> highEdges(highRadix * highRadix, mEdge::zero);
+            for (auto highPos = 0U; highPos < highEdges.size(); ++highPos) {
+                const std::vector<mEdge> lowEdges(edgesMat.begin() + static_cast<std::ptrdiff_t>(highPos * lowEntries),
+                                                  edgesMat.begin() + static_cast<std::ptrdiff_t>((highPos + 1) * lowEntries));
+                highEdges.at(highPos) = makeDDNode(currentReg, lowEdges);
+            }
+            currentReg++;
 
+            // process lines between the two targets
+            for (; currentReg < highTarget; currentReg++) {
+                for (auto highPos = 0U; highPos < highEdges.size(); ++highPos) {
+                    const bool onDiagonal = highPos / highRadix == highPos % highRadix;
+                    highEdges.at(highPos) = extendGateBlock(highEdges.at(highPos), currentReg, onDiagonal, controls, currentControl, start);
+                }
+                if (currentControl != controls.end() && currentControl->quantumRegister == currentReg) {
                     ++currentControl;
+                }
+            }
 
-                } else { // not connected
-                    for (auto iD = 0U; iD < nextRadix; iD++) {
-                        nextEdges.at(iD * nextRadix + iD) = targetNodeEdge;
-                    }
+            // higher target line
+            auto targetNodeEdge = makeDDNode(currentReg, highEdges);
+
+            // process lines above the higher target
+            for (; currentReg < static_cast<QuantumRegister>(n - 1 + start); currentReg++) {
+                auto nextReg   = static_cast<QuantumRegister>(currentReg + 1);
+                targetNodeEdge = extendGateBlock(targetNodeEdge, nextReg, true, controls, currentControl, start);
+                if (currentControl != controls.end() && currentControl->quantumRegister == nextReg) {
+                    ++currentControl;
                 }
-                targetNodeEdge = makeDDNode(nextReg, nextEdges);
             }
             return targetNodeEdge;
         }
 
+        /// Operations
+        // build the DD of an operation with one or two targets
+        mEdge makeOperationDD(const Operation& op, QuantumRegisterCount n, std::size_t start = 0) {
+            if (op.targets.size() == 1) {
+                const auto radix = registersSizes.at(static_cast<std::size_t>(op.targets.front()));
+                if (op.matrix.size() != radix * radix) {
+                    throw std::invalid_argument("Gate matrix has " + std::to_string(op.matrix.size()) +
+                                                " entries, but the target register requires " +
+                                                std::to_string(radix * radix) + ".");
+                }
+                return makeGateDD(op.matrix, n, op.controls, op.targets.front(), start);
+            }
+            if (op.targets.size() == 2) {
+                return makeTwoQuditGateDD(op.matrix, n, op.controls, op.targets.at(0), op.targets.at(1), start);
+            }
+            throw std::invalid_argument("Operations must act on one or two target registers.");
+        }
+
+        // apply a sequence of operations to a state. With `fuse` set, runs of operations on the same
+        // registers are first merged densely, such that each run costs a single matrix-vector multiplication.
+        vEdge applyOperations(const std::vector<Operation>& operations, vEdge state, bool fuse = true) {
+            const auto n = static_cast<QuantumRegisterCount>(numberOfQuantumRegisters);
+
+            for (const auto& op: (fuse ? fuseOperations(operations) : operations)) {
+                state = multiply(makeOperationDD(op, n), state);
+            }
+            return state;
+        }
+
+    private:
+        // wrap a block of a gate matrix into a node of register `reg`. Diagonal blocks act as identity on all
+        // levels of a control register except the controlling one, off-diagonal blocks vanish there.
+        mEdge extendGateBlock(const mEdge& block, QuantumRegister reg, bool onDiagonal,
+                              const Controls& controls, Controls::const_iterator currentControl,
+                              std::size_t start) {
+            auto               radix = registersSizes.at(static_cast<std::size_t>(reg));
+            std::vector<mEdge> quadEdges(radix * radix, mEdge::zero);
+
+            if (currentControl != controls.end() && currentControl->quantumRegister == reg) {
+                if (onDiagonal) {
+                    for (auto i = 0U; i < radix; i++) {
+                        if (i == currentControl->type) {
+                            quadEdges.at(i * radix + i) = block;
+                        } else {
+                            quadEdges.at(i * radix + i) = makeIdent(static_cast<QuantumRegister>(start), static_cast<QuantumRegister>(reg - 1));
+                        }
+                    }
+                } else {
+                    quadEdges.at(currentControl->type + radix * currentControl->type) = block;
+                }
+            } else { // not connected
+                for (auto iD = 0U; iD < radix; iD++) {
+                    quadEdges.at(iD * radix + iD) = block;
+                }
+            }
+            return makeDDNode(reg, quadEdges);
+        }
+
         ///
         /// Identity matrices
         ///
@@ -680,6 +1184,8 @@ namespace dd {
         ///
         ComputeTable<vCachedEdge, vCachedEdge, vCachedEdge> vectorAdd{};
         ComputeTable<mCachedEdge, mCachedEdge, mCachedEdge> matrixAdd{};
+        // tables added on top of the vector and matrix ones live on the heap to keep the package small enough for the stack
+        std::unique_ptr<ComputeTable<dCachedEdge, dCachedEdge, dCachedEdge>> densityAdd{std::make_unique<ComputeTable<dCachedEdge, dCachedEdge, dCachedEdge>>()};
 
         template<class Node>
         [[nodiscard]] ComputeTable<CachedEdge<Node>, CachedEdge<Node>,
@@ -738,14 +1244,27 @@ namespace dd {
                 return result;
             }
 
-            auto& computeTable = getAddComputeTable<Node>();
-            auto  result =
-                    computeTable.lookup({x.nextNode, x.weight}, {y.nextNode, y.weight});
+            // the table stores the sum of the operands divided by the weight of larger magnitude, i.e., it is keyed
+            // on the ratio of the weights and additions differing only by a common factor share an entry
+            auto&              computeTable = getAddComputeTable<Node>();
+            const auto         xWeight      = valueOf(x.weight);
+            const auto         yWeight      = valueOf(y.weight);
+            const bool         xDominates   = xWeight.mag2() >= yWeight.mag2();
+            const ComplexValue factor       = xDominates ? xWeight : yWeight;
+            const auto&        dominant     = xDominates ? x : y;
+            const auto&        other        = xDominates ? y : x;
+            const auto         ratio        = (xDominates ? yWeight : xWeight) / factor;
+
+            const CachedEdge<Node> dominantKey{dominant.nextNode, ComplexValue{1., 0.}};
+            const CachedEdge<Node> otherKey{other.nextNode, ratio};
+
+            auto result = computeTable.lookup(dominantKey, otherKey);
             if (result.nextNode != nullptr) {
-                if (result.weight.approximatelyZero()) {
+                const auto weight = result.weight * factor;
+                if (weight.approximatelyZero()) {
                     return Edge<Node>::zero;
                 }
-                return {result.nextNode, complexNumber.getCached(result.weight)};
+                return {result.nextNode, complexNumber.getCached(weight)};
             }
 
             QuantumRegister newSuccessor = 0;
@@ -764,7 +1283,18 @@ namespace dd {
             std::vector<Edge<Node>> edgeSum(x.nextNode->edges.size(),
                                             dd::Edge<Node>::zero);
 
-            for (auto i = 0U; i < x.nextNode->edges.size(); i++) {
+            // successors that are zero in both operands stay zero. The union never has more entries than edgeSum.
+            std::vector<std::uint16_t> successors(edgeSum.size());
+            if (!x.isTerminal() && !y.isTerminal() && x.nextNode->varIndx == y.nextNode->varIndx) {
+                successors.erase(std::set_union(x.nextNode->nonZeroEdges.begin(), x.nextNode->nonZeroEdges.end(),
+                                                y.nextNode->nonZeroEdges.begin(), y.nextNode->nonZeroEdges.end(),
+                                                successors.begin()),
+                                 successors.end());
+            } else {
+                std::iota(successors.begin(), successors.end(), 0U);
+            }
+
+            for (const auto i: successors) {
                 Edge<Node> e1{};
 
                 if (!x.isTerminal() && x.nextNode->varIndx == newSuccessor) {
@@ -808,8 +1338,7 @@ namespace dd {
             }
 
             auto e = makeDDNode(newSuccessor, edgeSum, true);
-            computeTable.insert({x.nextNode, x.weight}, {y.nextNode, y.weight},
-                                {e.nextNode, e.weight});
+            computeTable.insert(dominantKey, otherKey, {e.nextNode, valueOf(e.weight) / factor});
             return e;
         }
         ///
@@ -954,32 +1483,27 @@ namespace dd {
             const std::size_t cols                   = (std::is_same_v<RightOperandNode, mNode>) ? y.isTerminal() ? 1U : registersSizes.at(static_cast<std::size_t>(y.nextNode->varIndx)) : 1U;
             const std::size_t multiplicationBoundary = x.isTerminal() ? (y.isTerminal() ? 1U : registersSizes.at(static_cast<std::size_t>(y.nextNode->varIndx))) : registersSizes.at(static_cast<std::size_t>(x.nextNode->varIndx));
 
-            std::vector<ResultEdge> edge(multiplicationBoundary * cols, ResultEdge::zero);
+            auto edge = multiplyBlockIdentity(x, y, var, start);
 
-            for (auto i = 0U; i < rows; i++) {
-                for (auto j = 0U; j < cols; j++) {
-                    auto idx = cols * i + j;
-                    // edge.at(idx) = ResultEdge::zero;
+            if (edge.empty() && !x.isTerminal() && !y.isTerminal() &&
+                x.nextNode->varIndx == var && y.nextNode->varIndx == var) {
+                edge.assign(multiplicationBoundary * cols, ResultEdge::zero);
 
-                    for (auto k = 0U; k < multiplicationBoundary; k++) {
-                        LEdge e1{};
-                        if (!x.isTerminal() && x.nextNode->varIndx == var) {
-                            e1 = x.nextNode->edges.at(rows * i + k);
-                        } else {
-                            e1 = xCopy;
-                        }
+                // only pairs of nonzero successors x(i, k) and y(k, j) contribute to entry (i, j). Iterating x in
+                // row-major order accumulates every entry in ascending k as the dense loop below does.
+                const auto& yNonZero = y.nextNode->nonZeroEdges;
+                for (const auto xIdx: x.nextNode->nonZeroEdges) {
+                    const auto i = xIdx / multiplicationBoundary;
+                    const auto k = xIdx % multiplicationBoundary;
 
-                        REdge e2{};
-                        if (!y.isTerminal() && y.nextNode->varIndx == var) {
-                            e2 = y.nextNode->edges.at(j + cols * k);
-                        } else {
-                            e2 = yCopy;
-                        }
+                    auto yIt = std::lower_bound(yNonZero.begin(), yNonZero.end(), k * cols);
+                    for (; yIt != yNonZero.end() && *yIt < (k + 1) * cols; ++yIt) {
+                        const auto idx = cols * i + (*yIt - k * cols);
 
-                        auto multipliedRecurRes =
-                                multiply2(e1, e2, static_cast<QuantumRegister>(var - 1), start);
+                        auto multipliedRecurRes = multiply2(x.nextNode->edges.at(xIdx), y.nextNode->edges.at(*yIt),
+                                                            static_cast<QuantumRegister>(var - 1), start);
 
-                        if (k == 0 || edge.at(idx).weight == Complex::zero) {
+                        if (edge.at(idx).weight == Complex::zero) {
                             edge.at(idx) = multipliedRecurRes;
                         } else if (multipliedRecurRes.weight != Complex::zero) {
                             auto oldEdge = edge.at(idx);
@@ -990,6 +1514,45 @@ namespace dd {
                     }
                 }
             }
+
+            if (edge.empty()) {
+                edge.assign(multiplicationBoundary * cols, ResultEdge::zero);
+
+                for (auto i = 0U; i < rows; i++) {
+                    for (auto j = 0U; j < cols; j++) {
+                        auto idx = cols * i + j;
+                        // edge.at(idx) = ResultEdge::zero;
+
+                        for (auto k = 0U; k < multiplicationBoundary; k++) {
+                            LEdge e1{};
+                            if (!x.isTerminal() && x.nextNode->varIndx == var) {
+                                e1 = x.nextNode->edges.at(rows * i + k);
+                            } else {
+                                e1 = xCopy;
+                            }
+
+                            REdge e2{};
+                            if (!y.isTerminal() && y.nextNode->varIndx == var) {
+                                e2 = y.nextNode->edges.at(j + cols * k);
+                            } else {
+                                e2 = yCopy;
+                            }
+
+                            auto multipliedRecurRes =
+                                    multiply2(e1, e2, static_cast<QuantumRegister>(var - 1), start);
+
+                            if (k == 0 || edge.at(idx).weight == Complex::zero) {
+                                edge.at(idx) = multipliedRecurRes;
+                            } else if (multipliedRecurRes.weight != Complex::zero) {
+                                auto oldEdge = edge.at(idx);
+                                edge.at(idx) = add2(edge.at(idx), multipliedRecurRes);
+                                complexNumber.returnToCache(oldEdge.weight);
+                                complexNumber.returnToCache(multipliedRecurRes.weight);
+                            }
+                        }
+                    }
+                }
+            }
             resultEdge = makeDDNode(var, edge, true);
 
             computeTable.insert(xCopy, yCopy, {resultEdge.nextNode, resultEdge.weight});
@@ -1009,41 +1572,640 @@ namespace dd {
             }
             return resultEdge;
         }
-        ///
-        /// Inner product, fidelity, expectation value
-        ///
-    public:
-        ComputeTable<vEdge, vEdge, vCachedEdge> vectorInnerProduct{};
-
-        ComplexValue innerProduct(const vEdge& x, const vEdge& y) {
-            if (x.nextNode == nullptr || y.nextNode == nullptr ||
-                x.weight.approximatelyZero() ||
-                y.weight.approximatelyZero()) { // the 0 case
-                return {0, 0};
+        // successors of the product of x and y if one of them acts as identity on level `var`. Then every
+        // successor of the other operand only has to be multiplied with the diagonal successor once instead of
+        // summing over all products. Returns an empty vector if no shortcut applies.
+        template<class LeftOperandNode, class RightOperandNode>
+        std::vector<Edge<RightOperandNode>> multiplyBlockIdentity(const Edge<LeftOperandNode>&  x,
+                                                                  const Edge<RightOperandNode>& y,
+                                                                  QuantumRegister var, QuantumRegister start) {
+            if (x.isTerminal() || y.isTerminal() || x.nextNode->varIndx != var || y.nextNode->varIndx != var) {
+                return {};
             }
 
-            [[maybe_unused]] const auto before = complexNumber.cacheCount();
+            const auto                          nextVar = static_cast<QuantumRegister>(var - 1);
+            std::vector<Edge<RightOperandNode>> edge(y.nextNode->edges.size(), Edge<RightOperandNode>::zero);
 
-            auto circWidth = x.nextNode->varIndx;
-            if (y.nextNode->varIndx > circWidth) {
-                circWidth = y.nextNode->varIndx;
+            if (isBlockIdentity(x.nextNode) && isBlockIdentity(y.nextNode)) {
+                // the product acts as identity on this level as well
+                const auto basicDim = registersSizes.at(static_cast<std::size_t>(var));
+                const auto diagonal = multiply2(x.nextNode->edges.front(), y.nextNode->edges.front(), nextVar, start);
+                for (auto i = 0U; i < basicDim; ++i) {
+                    edge.at(i * basicDim + i) = (i == 0) ? diagonal : duplicateCached(diagonal);
+                }
+                return edge;
             }
-            const ComplexValue ip =
-                    innerProduct(x, y, static_cast<QuantumRegister>(circWidth + 1));
-
-            [[maybe_unused]] const auto after = complexNumber.cacheCount();
-            assert(after == before);
-
-            return ip;
+            if (isBlockIdentity(y.nextNode)) {
+                const auto& diagonal = y.nextNode->edges.front();
+                for (const auto i: x.nextNode->nonZeroEdges) {
+                    edge.at(i) = multiply2(x.nextNode->edges.at(i), diagonal, nextVar, start);
+                }
+                return edge;
+            }
+            if (isBlockIdentity(x.nextNode)) {
+                const auto& diagonal = x.nextNode->edges.front();
+                for (const auto i: y.nextNode->nonZeroEdges) {
+                    edge.at(i) = multiply2(diagonal, y.nextNode->edges.at(i), nextVar, start);
+                }
+                return edge;
+            }
+            return {};
         }
 
-        fp fidelity(const vEdge& x, const vEdge& y) {
-            const auto fid = innerProduct(x, y);
-            return fid.r * fid.r + fid.i * fid.i;
+        template<class Node>
+        static bool isBlockIdentity(const Node* node) {
+            if constexpr (std::is_same_v<Node, mNode>) {
+                return node->blockIdentity;
+            } else {
+                return false;
+            }
         }
 
-    private:
-        ComplexValue innerProduct(const vEdge& x, const vEdge& y,
+        // copy of an edge resulting from a cached computation that owns a separate cached weight, such that
+        // both copies may be consumed independently
+        template<class Node>
+        Edge<Node> duplicateCached(const Edge<Node>& e) {
+            if (e.weight == Complex::zero || e.weight == Complex::one) {
+                return e;
+            }
+            return {e.nextNode, complexNumber.getCached(CTEntry::val(e.weight.real), CTEntry::val(e.weight.img))};
+        }
+
+        ///
+        /// Multiplication with the adjoint
+        ///
+    public:
+        std::unique_ptr<ComputeTable<mEdge, vEdge, vCachedEdge>> matrixVectorAdjointMultiplication{std::make_unique<ComputeTable<mEdge, vEdge, vCachedEdge>>()};
+        std::unique_ptr<ComputeTable<mEdge, mEdge, mCachedEdge>> matrixMatrixAdjointMultiplication{std::make_unique<ComputeTable<mEdge, mEdge, mCachedEdge>>()};
+
+        template<class RightOperandNode>
+        [[nodiscard]] ComputeTable<mEdge, Edge<RightOperandNode>, CachedEdge<RightOperandNode>>&
+        getAdjointMultiplicationComputeTable();
+
+        // product of the conjugate transpose of x with y. The successors of x are read conjugate transposed
+        // during the recursion, so the conjugate transpose of x is never built.
+        template<class RightOperand>
+        RightOperand multiplyAdjoint(const mEdge& x, const RightOperand& y, dd::QuantumRegister start = 0) {
+            [[maybe_unused]] const auto before = complexNumber.cacheCount();
+
+            QuantumRegister var = -1;
+            if (!x.isTerminal()) {
+                var = x.nextNode->varIndx;
+            }
+            if (!y.isTerminal() && (y.nextNode->varIndx) > var) {
+                var = y.nextNode->varIndx;
+            }
+
+            RightOperand e = multiplyAdjoint2(x, y, var, start);
+
+            if (e.weight != Complex::zero && e.weight != Complex::one) {
+                complexNumber.returnToCache(e.weight);
+                e.weight = complexNumber.lookup(e.weight);
+            }
+
+            [[maybe_unused]] const auto after = complexNumber.cacheCount();
+            assert(before == after);
+
+            return e;
+        }
+
+    private:
+        template<class RightOperandNode>
+        Edge<RightOperandNode> multiplyAdjoint2(const mEdge& x, const Edge<RightOperandNode>& y, QuantumRegister var,
+                                                QuantumRegister start) {
+            using ResultEdge = Edge<RightOperandNode>;
+
+            if (x.weight == Complex::zero || y.weight == Complex::zero) {
+                return ResultEdge::zero;
+            }
+            const auto xWeight = ComplexNumbers::conj(x.weight);
+            if (var == start - 1) {
+                return ResultEdge::terminal(complexNumber.mulCached(xWeight, y.weight));
+            }
+            // DDs span all registers, so the terminals are reached simultaneously
+            assert(!x.isTerminal() && !y.isTerminal() && x.nextNode->varIndx == var && y.nextNode->varIndx == var);
+
+            const mEdge xCopy{x.nextNode, Complex::one};
+            const ResultEdge yCopy{y.nextNode, Complex::one};
+
+            auto& computeTable = getAdjointMultiplicationComputeTable<RightOperandNode>();
+            auto  resultEdge   = ResultEdge{};
+
+            const auto lookupResult = computeTable.lookup(xCopy, yCopy);
+            if (lookupResult.nextNode != nullptr) {
+                if (lookupResult.weight.approximatelyZero()) {
+                    return ResultEdge::zero;
+                }
+                resultEdge = {lookupResult.nextNode, complexNumber.getCached(lookupResult.weight)};
+            } else {
+                if (x.nextNode->identity) {
+                    resultEdge = yCopy;
+                } else {
+                    const auto nextVar  = static_cast<QuantumRegister>(var - 1);
+                    const auto basicDim = registersSizes.at(static_cast<std::size_t>(var));
+                    const auto cols     = std::is_same_v<RightOperandNode, mNode> ? basicDim : 1U;
+
+                    std::vector<ResultEdge> edge(basicDim * cols, ResultEdge::zero);
+                    if (x.nextNode->blockIdentity) {
+                        // the conjugate transpose acts as identity on this level as well
+                        const auto& diagonal = x.nextNode->edges.front();
+                        for (const auto i: y.nextNode->nonZeroEdges) {
+                            edge.at(i) = multiplyAdjoint2(diagonal, y.nextNode->edges.at(i), nextVar, start);
+                        }
+                    } else {
+                        // entry (i, j) is the sum over k of conj(x(k, i)) * y(k, j)
+                        const auto& yNonZero = y.nextNode->nonZeroEdges;
+                        for (const auto xIdx: x.nextNode->nonZeroEdges) {
+                            const auto k = xIdx / basicDim;
+                            const auto i = xIdx % basicDim;
+
+                            auto yIt = std::lower_bound(yNonZero.begin(), yNonZero.end(), k * cols);
+                            for (; yIt != yNonZero.end() && *yIt < (k + 1) * cols; ++yIt) {
+                                const auto idx     = cols * i + (*yIt - k * cols);
+                                auto       product = multiplyAdjoint2(x.nextNode->edges.at(xIdx), y.nextNode->edges.at(*yIt), nextVar, start);
+
+                                if (edge.at(idx).weight == Complex::zero) {
+                                    edge.at(idx) = product;
+                                } else if (product.weight != Complex::zero) {
+                                    auto oldEdge = edge.at(idx);
+                                    edge.at(idx) = add2(edge.at(idx), product);
+                                    complexNumber.returnToCache(oldEdge.weight);
+                                    complexNumber.returnToCache(product.weight);
+                                }
+                            }
+                        }
+                    }
+                    resultEdge = makeDDNode(var, edge, true);
+                }
+                computeTable.insert(xCopy, yCopy, {resultEdge.nextNode, resultEdge.weight});
+                if (resultEdge.weight == Complex::zero) {
+                    return ResultEdge::zero;
+                }
+                if (resultEdge.weight == Complex::one) {
+                    resultEdge.weight = complexNumber.getCached(1., 0.);
+                }
+            }
+
+            ComplexNumbers::mul(resultEdge.weight, resultEdge.weight, xWeight);
+            ComplexNumbers::mul(resultEdge.weight, resultEdge.weight, y.weight);
+            if (resultEdge.weight.approximatelyZero()) {
+                complexNumber.returnToCache(resultEdge.weight);
+                return ResultEdge::zero;
+            }
+            return resultEdge;
+        }
+
+        ///
+        /// Batched multiplication
+        ///
+    public:
+        struct BatchStatistics {
+            std::size_t states{};              // size of the batch
+            std::size_t distinctStates{};      // states with distinct root nodes, each of which is multiplied once
+            std::size_t gateNodeVisits{};      // gate nodes expanded, each once for all operands of the batch reaching it
+            std::size_t operandVisits{};       // products of gate and state nodes expanded, i.e., the node visits of
+                                               // multiplying the states one after another
+            std::size_t computeTableLookups{}; // sub-products looked up while multiplying the batch
+            std::size_t computeTableHits{};    // sub-products reused from earlier states or previous computations
+        };
+
+        std::vector<vEdge> multiplyBatch(const mEdge& gate, const std::vector<vEdge>& states) {
+            BatchStatistics statistics{};
+            return multiplyBatch(gate, states, statistics);
+        }
+
+        // apply gate to every state of the batch in a single traversal of the gate. The operands reaching a gate
+        // node are expanded together, i.e., every nonzero successor of the gate node is visited once per batch
+        // with the successors of all operands, and the buffers of the intermediate products are reused across
+        // the batch. Gate and states have to span the same registers.
+        std::vector<vEdge> multiplyBatch(const mEdge& gate, const std::vector<vEdge>& states, BatchStatistics& statistics) {
+            [[maybe_unused]] const auto before = complexNumber.cacheCount();
+
+            auto&      computeTable = matrixVectorMultiplication;
+            const auto lookups      = computeTable.getLookups();
+            const auto hits         = computeTable.getHits();
+
+            statistics        = {};
+            statistics.states = states.size();
+
+            const auto var = gate.isTerminal() ? static_cast<QuantumRegister>(-1) : gate.nextNode->varIndx;
+
+            // operands of weight one, one for every distinct root node
+            constexpr auto                            NO_OPERAND = std::numeric_limits<std::size_t>::max();
+            std::vector<vEdge>                        operands{};
+            std::vector<std::size_t>                  operandOf(states.size(), NO_OPERAND);
+            std::unordered_map<vNode*, std::size_t>   positions{};
+            for (auto i = 0U; i < states.size(); ++i) {
+                const auto& state = states.at(i);
+                if (state.weight.approximatelyZero()) {
+                    continue;
+                }
+                if ((state.isTerminal() ? static_cast<QuantumRegister>(-1) : state.nextNode->varIndx) != var) {
+                    throw std::invalid_argument("States of a batch have to span the same registers as the gate.");
+                }
+                const auto it = positions.emplace(state.nextNode, operands.size()).first;
+                if (it->second == operands.size()) {
+                    operands.push_back({state.nextNode, Complex::one});
+                }
+                operandOf.at(i) = it->second;
+            }
+            statistics.distinctStates = operands.size();
+
+            std::vector<vEdge> products{};
+            if (!operands.empty() && !gate.weight.approximatelyZero()) {
+                std::vector<BatchLevel> levels(static_cast<std::size_t>(var + 1));
+                multiplyBatch2(mEdge{gate.nextNode, Complex::one}, operands, var, products, levels, statistics);
+            }
+
+            std::vector<vEdge> results(states.size(), vEdge::zero);
+            for (auto i = 0U; i < states.size(); ++i) {
+                if (operandOf.at(i) == NO_OPERAND || products.empty()) {
+                    continue;
+                }
+                const auto& product = products.at(operandOf.at(i));
+                if (product.weight == Complex::zero) {
+                    continue;
+                }
+                const auto weight = complexNumber.lookup(valueOf(product.weight) * valueOf(gate.weight) * valueOf(states.at(i).weight));
+                if (weight != Complex::zero) {
+                    results.at(i) = {product.nextNode, weight};
+                }
+            }
+            for (auto& product: products) {
+                if (product.weight != Complex::zero && product.weight != Complex::one) {
+                    complexNumber.returnToCache(product.weight);
+                }
+            }
+
+            statistics.computeTableLookups = computeTable.getLookups() - lookups;
+            statistics.computeTableHits    = computeTable.getHits() - hits;
+
+            [[maybe_unused]] const auto after = complexNumber.cacheCount();
+            assert(before == after);
+            return results;
+        }
+
+    private:
+        // buffers of one level of the batched multiplication, reused by all its calls on that level
+        struct BatchLevel {
+            std::vector<std::pair<vNode*, std::size_t>> pending{};      // operands missing from the compute table
+            std::vector<vNode*>                         distinct{};     // distinct nodes of the pending operands
+            std::vector<std::size_t>                    distinctOf{};   // distinct node of every pending operand
+            std::vector<vEdge>                          sums{};         // successors of the products of the distinct nodes
+            std::vector<vEdge>                          successors{};   // operand successors multiplied with a gate successor
+            std::vector<std::size_t>                    owners{};       // distinct node every operand successor belongs to
+            std::vector<vEdge>                          subProducts{};  // products of the operand successors
+            std::vector<vEdge>                          products{};     // products of the distinct nodes
+        };
+
+        // products of x with all operands ys, in the manner of multiply2: the weights of the results are cached and
+        // every sub-product is stored in and looked up from the matrix-vector compute table
+        void multiplyBatch2(const mEdge& x, const std::vector<vEdge>& ys, QuantumRegister var, std::vector<vEdge>& results,
+                            std::vector<BatchLevel>& levels, BatchStatistics& statistics) {
+            results.assign(ys.size(), vEdge::zero);
+            if (var < 0) {
+                for (auto b = 0U; b < ys.size(); ++b) {
+                    results.at(b) = vEdge::terminal(complexNumber.mulCached(x.weight, ys.at(b).weight));
+                }
+                return;
+            }
+
+            auto&       level        = levels.at(static_cast<std::size_t>(var));
+            auto&       computeTable = matrixVectorMultiplication;
+            const mEdge xCopy{x.nextNode, Complex::one};
+            const auto  xWeight = valueOf(x.weight);
+            const auto  scaled  = [this, &xWeight](vNode* node, const ComplexValue& weight, const Complex& operandWeight) {
+                auto product = complexNumber.getCached(weight * xWeight * valueOf(operandWeight));
+                if (product.approximatelyZero()) {
+                    complexNumber.returnToCache(product);
+                    return vEdge::zero;
+                }
+                return vEdge{node, product};
+            };
+
+            level.pending.clear();
+            for (auto b = 0U; b < ys.size(); ++b) {
+                const auto cached = computeTable.lookup(xCopy, vEdge{ys.at(b).nextNode, Complex::one});
+                if (cached.nextNode == nullptr) {
+                    level.pending.emplace_back(ys.at(b).nextNode, b);
+                } else if (!cached.weight.approximatelyZero()) {
+                    results.at(b) = scaled(cached.nextNode, cached.weight, ys.at(b).weight);
+                }
+            }
+            if (level.pending.empty()) {
+                return;
+            }
+
+            std::sort(level.pending.begin(), level.pending.end());
+            level.distinct.clear();
+            level.distinctOf.clear();
+            for (const auto& [node, b]: level.pending) {
+                if (level.distinct.empty() || level.distinct.back() != node) {
+                    level.distinct.push_back(node);
+                }
+                level.distinctOf.push_back(level.distinct.size() - 1);
+            }
+            ++statistics.gateNodeVisits;
+            statistics.operandVisits += level.distinct.size();
+
+            level.products.assign(level.distinct.size(), vEdge::zero);
+            if (x.nextNode->identity) {
+                for (auto u = 0U; u < level.distinct.size(); ++u) {
+                    level.products.at(u) = {level.distinct.at(u), Complex::one};
+                }
+            } else {
+                const auto dim = registersSizes.at(static_cast<std::size_t>(var));
+                level.sums.assign(level.distinct.size() * dim, vEdge::zero);
+                for (const auto xIdx: x.nextNode->nonZeroEdges) {
+                    const auto i = xIdx / dim;
+                    const auto k = xIdx % dim;
+
+                    level.successors.clear();
+                    level.owners.clear();
+                    for (auto u = 0U; u < level.distinct.size(); ++u) {
+                        const auto& successor = level.distinct.at(u)->edges.at(k);
+                        if (successor.weight != Complex::zero) {
+                            level.successors.push_back(successor);
+                            level.owners.push_back(u);
+                        }
+                    }
+                    if (level.successors.empty()) {
+                        continue;
+                    }
+
+                    multiplyBatch2(x.nextNode->edges.at(xIdx), level.successors, static_cast<QuantumRegister>(var - 1),
+                                   level.subProducts, levels, statistics);
+                    for (auto j = 0U; j < level.owners.size(); ++j) {
+                        auto& sum        = level.sums.at(level.owners.at(j) * dim + i);
+                        auto& subProduct = level.subProducts.at(j);
+                        if (sum.weight == Complex::zero) {
+                            sum = subProduct;
+                        } else if (subProduct.weight != Complex::zero) {
+                            auto oldSum = sum;
+                            sum         = add2(sum, subProduct);
+                            complexNumber.returnToCache(oldSum.weight);
+                            complexNumber.returnToCache(subProduct.weight);
+                        }
+                    }
+                }
+                for (auto u = 0U; u < level.distinct.size(); ++u) {
+                    const auto first     = level.sums.begin() + static_cast<std::ptrdiff_t>(u * dim);
+                    level.products.at(u) = makeDDNode(var, std::vector<vEdge>(first, first + static_cast<std::ptrdiff_t>(dim)), true);
+                }
+            }
+
+            for (auto u = 0U; u < level.distinct.size(); ++u) {
+                const auto& product = level.products.at(u);
+                computeTable.insert(xCopy, vEdge{level.distinct.at(u), Complex::one}, {product.nextNode, product.weight});
+            }
+            for (auto p = 0U; p < level.pending.size(); ++p) {
+                const auto& product = level.products.at(level.distinctOf.at(p));
+                const auto  b       = level.pending.at(p).second;
+                if (product.weight != Complex::zero) {
+                    results.at(b) = scaled(product.nextNode, valueOf(product.weight), ys.at(b).weight);
+                }
+            }
+            for (auto& product: level.products) {
+                if (product.weight != Complex::zero && product.weight != Complex::one) {
+                    complexNumber.returnToCache(product.weight);
+                }
+            }
+        }
+
+        ///
+        /// Parallel multiplication
+        ///
+    public:
+        // multiply x and y, evaluating the independent sub-products below the top `levels` levels as tasks on a
+        // work-stealing pool. Every worker computes in a package of its own that shares the tables of this one.
+        template<class RightOperand>
+        RightOperand multiplyParallel(const mEdge& x, const RightOperand& y,
+                                      std::size_t threads = std::thread::hardware_concurrency(),
+                                      std::size_t levels  = 2) {
+            using RightOperandNode = std::remove_pointer_t<decltype(y.nextNode)>;
+
+            if (x.weight.approximatelyZero() || y.weight.approximatelyZero()) {
+                return RightOperand::zero;
+            }
+            if (threads <= 1 || x.isTerminal() || y.isTerminal() || x.nextNode->varIndx != y.nextNode->varIndx) {
+                return multiply(x, y);
+            }
+            const auto var = x.nextNode->varIndx;
+            levels         = std::min(levels, static_cast<std::size_t>(var));
+            if (levels == 0) {
+                return multiply(x, y);
+            }
+
+            auto& pool = getThreadPool(threads);
+
+            std::vector<ProductBlock<RightOperandNode>> blocks{};
+            const ProductBlock<RightOperandNode>        root{{x.nextNode, y.nextNode, valueOf(x.weight) * valueOf(y.weight)}};
+            expandProductBlock(root, var, levels, blocks);
+
+            std::vector<std::future<RightOperand>> partialProducts(blocks.size());
+            for (auto i = 0U; i < blocks.size(); ++i) {
+                if (!blocks.at(i).empty()) {
+                    partialProducts.at(i) = pool.submit([this, &block = blocks.at(i)]() {
+                        return workerPackages.at(ThreadPool::currentWorker())->sumProducts(block);
+                    });
+                }
+            }
+
+            std::vector<RightOperand> results(blocks.size(), RightOperand::zero);
+            for (auto i = 0U; i < blocks.size(); ++i) {
+                if (partialProducts.at(i).valid()) {
+                    results.at(i) = partialProducts.at(i).get();
+                }
+            }
+
+            std::size_t next = 0;
+            return assembleBlocks(results, var, levels, next);
+        }
+
+    private:
+        std::unique_ptr<ThreadPool>              threadPool{};
+        std::vector<std::unique_ptr<MDDPackage>> workerPackages{};
+
+        // sum of the products left * right * factor, where left and right are nodes of the same level
+        template<class RightOperandNode>
+        struct ProductTerm {
+            mNode*            left;
+            RightOperandNode* right;
+            ComplexValue      factor;
+        };
+        template<class RightOperandNode>
+        using ProductBlock = std::vector<ProductTerm<RightOperandNode>>;
+
+        static ComplexValue valueOf(const Complex& c) {
+            return {CTEntry::val(c.real), CTEntry::val(c.img)};
+        }
+
+        ThreadPool& getThreadPool(std::size_t threads) {
+            if (threadPool == nullptr || threadPool->size() != threads ||
+                workerPackages.front()->registersSizes != registersSizes) {
+                threadPool.reset();
+                workerPackages.clear();
+                for (auto i = 0U; i < threads; ++i) {
+                    workerPackages.push_back(std::make_unique<MDDPackage>(*this, SharedTables{}));
+                }
+                threadPool = std::make_unique<ThreadPool>(threads);
+            }
+            return *threadPool;
+        }
+
+        // split the products of a block into the blocks of their successors `levels` levels further down
+        template<class RightOperandNode>
+        void expandProductBlock(const ProductBlock<RightOperandNode>& block, QuantumRegister var, std::size_t levels,
+                                std::vector<ProductBlock<RightOperandNode>>& blocks) {
+            if (levels == 0) {
+                blocks.push_back(block);
+                return;
+            }
+
+            const auto basicDim = registersSizes.at(static_cast<std::size_t>(var));
+            const auto cols     = std::is_same_v<RightOperandNode, mNode> ? basicDim : 1U;
+
+            std::vector<ProductBlock<RightOperandNode>> successors(basicDim * cols);
+            for (const auto& term: block) {
+                const auto& rightNonZero = term.right->nonZeroEdges;
+                for (const auto leftIdx: term.left->nonZeroEdges) {
+                    const auto  i        = leftIdx / basicDim;
+                    const auto  k        = leftIdx % basicDim;
+                    const auto& leftEdge = term.left->edges.at(leftIdx);
+
+                    auto rightIt = std::lower_bound(rightNonZero.begin(), rightNonZero.end(), k * cols);
+                    for (; rightIt != rightNonZero.end() && *rightIt < (k + 1) * cols; ++rightIt) {
+                        const auto& rightEdge = term.right->edges.at(*rightIt);
+                        successors.at(cols * i + (*rightIt - k * cols))
+                                .push_back({leftEdge.nextNode, rightEdge.nextNode,
+                                            term.factor * valueOf(leftEdge.weight) * valueOf(rightEdge.weight)});
+                    }
+                }
+            }
+            for (const auto& successor: successors) {
+                expandProductBlock(successor, static_cast<QuantumRegister>(var - 1), levels - 1, blocks);
+            }
+        }
+
+        template<class RightOperandNode>
+        Edge<RightOperandNode> sumProducts(const ProductBlock<RightOperandNode>& block) {
+            auto sum = Edge<RightOperandNode>::zero;
+            for (const auto& term: block) {
+                const auto product = multiply(mEdge{term.left, Complex::one}, Edge<RightOperandNode>{term.right, Complex::one});
+                const auto weight  = complexNumber.lookup(valueOf(product.weight) * term.factor);
+                if (weight != Complex::zero) {
+                    sum = add(sum, Edge<RightOperandNode>{product.nextNode, weight});
+                }
+            }
+            return sum;
+        }
+
+        // rebuild the top `levels` levels above the results of expandProductBlock
+        template<class Edge>
+        Edge assembleBlocks(const std::vector<Edge>& results, QuantumRegister var, std::size_t levels, std::size_t& next) {
+            if (levels == 0) {
+                return results.at(next++);
+            }
+
+            const auto basicDim = registersSizes.at(static_cast<std::size_t>(var));
+            const auto cols     = std::is_same_v<Edge, mEdge> ? basicDim : 1U;
+
+            std::vector<Edge> edges(basicDim * cols, Edge::zero);
+            for (auto& edge: edges) {
+                edge = assembleBlocks(results, static_cast<QuantumRegister>(var - 1), levels - 1, next);
+            }
+            return makeDDNode(var, edges);
+        }
+
+        ///
+        /// Inner product, fidelity, expectation value
+        ///
+    public:
+        ComputeTable<vEdge, vEdge, vCachedEdge> vectorInnerProduct{};
+
+        ComplexValue innerProduct(const vEdge& x, const vEdge& y) {
+            if (x.nextNode == nullptr || y.nextNode == nullptr ||
+                x.weight.approximatelyZero() ||
+                y.weight.approximatelyZero()) { // the 0 case
+                return {0, 0};
+            }
+
+            [[maybe_unused]] const auto before = complexNumber.cacheCount();
+
+            auto circWidth = x.nextNode->varIndx;
+            if (y.nextNode->varIndx > circWidth) {
+                circWidth = y.nextNode->varIndx;
+            }
+            const ComplexValue ip =
+                    innerProduct(x, y, static_cast<QuantumRegister>(circWidth + 1));
+
+            [[maybe_unused]] const auto after = complexNumber.cacheCount();
+            assert(after == before);
+
+            return ip;
+        }
+
+        fp fidelity(const vEdge& x, const vEdge& y) {
+            const auto fid = innerProduct(x, y);
+            return fid.r * fid.r + fid.i * fid.i;
+        }
+
+        std::unique_ptr<TernaryComputeTable<vEdge, mEdge, vEdge, vCachedEdge>> vectorExpectationValue{std::make_unique<TernaryComputeTable<vEdge, mEdge, vEdge, vCachedEdge>>()};
+
+        // <state|op|state> computed in a single traversal of the three DDs without building op|state>
+        ComplexValue expectationValue(const mEdge& op, const vEdge& state) {
+            if (op.nextNode == nullptr || state.nextNode == nullptr ||
+                op.weight.approximatelyZero() || state.weight.approximatelyZero()) {
+                return {0., 0.};
+            }
+            if (op.isTerminal() != state.isTerminal() ||
+                (!op.isTerminal() && op.nextNode->varIndx != state.nextNode->varIndx)) {
+                throw std::invalid_argument("Operator and state have to act on the same registers.");
+            }
+
+            const auto weight = valueOf(state.weight);
+            return conj(weight) * valueOf(op.weight) * weight * expectationValue(state.nextNode, op.nextNode, state.nextNode);
+        }
+
+    private:
+        static ComplexValue conj(const ComplexValue& c) {
+            return {c.r, -c.i};
+        }
+
+        // <bra|op|ket> for unit weights on the three nodes
+        ComplexValue expectationValue(vNode* bra, mNode* op, vNode* ket) {
+            // DDs span all registers, so the terminals are reached simultaneously
+            assert(vNode::isTerminal(bra) == mNode::isTerminal(op) && vNode::isTerminal(ket) == mNode::isTerminal(op));
+            if (mNode::isTerminal(op)) {
+                return {1., 0.};
+            }
+
+            const vEdge braKey{bra, Complex::one};
+            const mEdge opKey{op, Complex::one};
+            const vEdge ketKey{ket, Complex::one};
+            const auto  cached = vectorExpectationValue->lookup(braKey, opKey, ketKey);
+            if (cached.nextNode != nullptr) {
+                return cached.weight;
+            }
+
+            const auto   basicDim = registersSizes.at(static_cast<std::size_t>(op->varIndx));
+            ComplexValue sum{0., 0.};
+            for (const auto idx: op->nonZeroEdges) {
+                const auto& braEdge = bra->edges.at(idx / basicDim);
+                const auto& ketEdge = ket->edges.at(idx % basicDim);
+                if (braEdge.weight == Complex::zero || ketEdge.weight == Complex::zero) {
+                    continue;
+                }
+                const auto& opEdge = op->edges.at(idx);
+                sum += conj(valueOf(braEdge.weight)) * valueOf(opEdge.weight) * valueOf(ketEdge.weight) *
+                       expectationValue(braEdge.nextNode, opEdge.nextNode, ketEdge.nextNode);
+            }
+
+            vectorExpectationValue->insert(braKey, opKey, ketKey, {vNode::terminal, sum});
+            return sum;
+        }
+
+        ComplexValue innerProduct(const vEdge& x, const vEdge& y,
                                   QuantumRegister var) {
             if (x.nextNode == nullptr || y.nextNode == nullptr ||
                 x.weight.approximatelyZero() ||
@@ -1051,54 +2213,762 @@ namespace dd {
                 return {0.0, 0.0};
             }
 
-            if (var == 0) {
-                auto c = complexNumber.getTemporary();
-                ComplexNumbers::mul(c, x.weight, y.weight);
-                return {c.real->value, c.img->value};
+            if (var == 0) {
+                auto c = complexNumber.getTemporary();
+                ComplexNumbers::mul(c, x.weight, y.weight);
+                return {c.real->value, c.img->value};
+            }
+
+            auto xCopy   = x;
+            xCopy.weight = Complex::one;
+            auto yCopy   = y;
+            yCopy.weight = Complex::one;
+
+            auto nodeLookup = vectorInnerProduct.lookup(xCopy, yCopy);
+            if (nodeLookup.nextNode != nullptr) {
+                auto c = complexNumber.getTemporary(nodeLookup.weight);
+                ComplexNumbers::mul(c, c, x.weight);
+                ComplexNumbers::mul(c, c, y.weight);
+                return {CTEntry::val(c.real), CTEntry::val(c.img)};
+            }
+
+            auto width = static_cast<QuantumRegister>(var - 1);
+
+            // only successors that are nonzero in both vectors contribute
+            std::vector<std::uint16_t> successors{};
+            if (!x.isTerminal() && x.nextNode->varIndx == width && !y.isTerminal() && y.nextNode->varIndx == width) {
+                std::set_intersection(x.nextNode->nonZeroEdges.begin(), x.nextNode->nonZeroEdges.end(),
+                                      y.nextNode->nonZeroEdges.begin(), y.nextNode->nonZeroEdges.end(),
+                                      std::back_inserter(successors));
+            } else {
+                successors.resize(registersSizes.at(static_cast<std::size_t>(width)));
+                std::iota(successors.begin(), successors.end(), 0U);
+            }
+
+            ComplexValue sum{0.0, 0.0};
+            for (const auto i: successors) {
+                vEdge e1{};
+                if (!x.isTerminal() && x.nextNode->varIndx == width) {
+                    e1 = x.nextNode->edges.at(i);
+                } else {
+                    e1 = xCopy;
+                }
+                vEdge e2{};
+                if (!y.isTerminal() && y.nextNode->varIndx == width) {
+                    e2        = y.nextNode->edges.at(i);
+                    e2.weight = ComplexNumbers::conj(e2.weight);
+                } else {
+                    e2 = yCopy;
+                }
+                auto cv = innerProduct(e1, e2, width);
+                sum.r += cv.r;
+                sum.i += cv.i;
+            }
+            nodeLookup.nextNode = vNode::terminal;
+            nodeLookup.weight   = sum;
+
+            vectorInnerProduct.insert(xCopy, yCopy, nodeLookup);
+            auto c = complexNumber.getTemporary(sum);
+            ComplexNumbers::mul(c, c, x.weight);
+            ComplexNumbers::mul(c, c, y.weight);
+            return {CTEntry::val(c.real), CTEntry::val(c.img)};
+        }
+
+        ///
+        /// Measurement and sampling
+        ///
+    public:
+        // outcomes are given by their mixed-radix digits, i.e., entry i is the level of register i. Unlike a linear
+        // index, this representation does not overflow for large systems.
+        using SampleCounts = std::map<std::vector<std::size_t>, std::size_t>;
+
+        // draw `shots` samples of measuring all registers. The shots reaching a node are split among its successors
+        // by a single multinomial draw, so the cost grows with the number of distinct outcomes instead of the shots.
+        template<class Generator>
+        SampleCounts sample(const vEdge& state, std::size_t shots, Generator& gen) {
+            if (state.nextNode == nullptr || state.weight.approximatelyZero()) {
+                throw std::invalid_argument("Cannot sample from the zero vector.");
+            }
+
+            SampleCounts counts{};
+            if (shots == 0) {
+                return counts;
+            }
+            if (state.isTerminal()) {
+                counts.emplace(std::vector<std::size_t>{}, shots);
+                return counts;
+            }
+            std::vector<std::size_t> digits(static_cast<std::size_t>(state.nextNode->varIndx) + 1U, 0U);
+            sample(state.nextNode, shots, digits, counts, gen);
+            return counts;
+        }
+
+        SampleCounts sample(const vEdge& state, std::size_t shots) {
+            std::mt19937_64 gen(std::random_device{}());
+            return sample(state, shots, gen);
+        }
+
+        // squared norm of the vector represented by a node with unit incoming weight
+        fp subtreeNorm(vNode* node) {
+            if (vNode::isTerminal(node)) {
+                return 1.;
+            }
+            const vEdge key{node, Complex::one};
+            const auto  cached = subtreeNorms->lookup(key);
+            if (cached.nextNode != nullptr) {
+                return cached.weight.r;
+            }
+
+            fp norm = 0.;
+            for (const auto i: node->nonZeroEdges) {
+                const auto& edge = node->edges.at(i);
+                norm += ComplexNumbers::mag2(edge.weight) * subtreeNorm(edge.nextNode);
+            }
+            subtreeNorms->insert(key, {vNode::terminal, {norm, 0.}});
+            return norm;
+        }
+
+        // probabilities of the outcomes of measuring register `reg`, they sum up to the squared norm of the state
+        std::vector<fp> measurementProbabilities(const vEdge& state, QuantumRegister reg) {
+            if (state.isTerminal() || reg < 0 || reg > state.nextNode->varIndx) {
+                throw std::invalid_argument("Register to measure is not part of the state.");
+            }
+
+            // squared magnitude of all paths from the root to the nodes of the current level
+            std::unordered_map<const vNode*, fp> mass{{state.nextNode, ComplexNumbers::mag2(state.weight)}};
+            for (auto level = state.nextNode->varIndx; level > reg; --level) {
+                std::unordered_map<const vNode*, fp> next{};
+                for (const auto& [node, m]: mass) {
+                    for (const auto i: node->nonZeroEdges) {
+                        const auto& edge = node->edges.at(i);
+                        next[edge.nextNode] += m * ComplexNumbers::mag2(edge.weight);
+                    }
+                }
+                mass = std::move(next);
+            }
+
+            std::vector<fp> probabilities(registersSizes.at(static_cast<std::size_t>(reg)), 0.);
+            for (const auto& [node, m]: mass) {
+                for (const auto i: node->nonZeroEdges) {
+                    const auto& edge = node->edges.at(i);
+                    probabilities.at(i) += m * ComplexNumbers::mag2(edge.weight) * subtreeNorm(edge.nextNode);
+                }
+            }
+            return probabilities;
+        }
+
+        // joint distribution of measuring the given registers, dense over their mixed-radix space with
+        // registers.at(0) as the least significant digit
+        std::vector<fp> marginals(const vEdge& state, const std::vector<QuantumRegister>& registers) {
+            // selected registers in ascending order together with their stride in the result
+            std::vector<std::pair<QuantumRegister, std::size_t>> selected{};
+            std::size_t                                          stride = 1;
+            for (const auto reg: registers) {
+                if (state.isTerminal() || reg < 0 || reg > state.nextNode->varIndx) {
+                    throw std::invalid_argument("Register of the marginal distribution is not part of the state.");
+                }
+                selected.emplace_back(reg, stride);
+                stride *= registersSizes.at(static_cast<std::size_t>(reg));
+            }
+            std::sort(selected.begin(), selected.end());
+            if (std::adjacent_find(selected.begin(), selected.end(), [](const auto& a, const auto& b) { return a.first == b.first; }) != selected.end()) {
+                throw std::invalid_argument("Registers of the marginal distribution have to be distinct.");
+            }
+            if (selected.empty()) {
+                return {ComplexNumbers::mag2(state.weight) * subtreeNorm(state.nextNode)};
+            }
+
+            // the distribution of a node has the lowest selected register as least significant digit
+            std::unordered_map<const vNode*, std::vector<fp>> distributions{};
+            const auto&                                       distribution = marginalDistribution(state.nextNode, selected, distributions);
+
+            const auto      weight = ComplexNumbers::mag2(state.weight);
+            std::vector<fp> result(stride, 0.);
+            for (std::size_t index = 0; index < distribution.size(); ++index) {
+                auto        remainder = index;
+                std::size_t target    = 0;
+                for (const auto& [reg, regStride]: selected) {
+                    const auto dim = registersSizes.at(static_cast<std::size_t>(reg));
+                    target += (remainder % dim) * regStride;
+                    remainder /= dim;
+                }
+                result.at(target) = weight * distribution.at(index);
+            }
+            return result;
+        }
+
+        // measure register `reg`, collapse `state` to the observed outcome and renormalize it.
+        // The result keeps the phase of the remaining amplitudes.
+        template<class Generator>
+        std::size_t measureOneCollapsing(vEdge& state, QuantumRegister reg, Generator& gen) {
+            const auto probabilities = measurementProbabilities(state, reg);
+            std::discrete_distribution<std::size_t> distribution(probabilities.begin(), probabilities.end());
+            const auto outcome = distribution(gen);
+
+            std::unordered_map<const vNode*, vEdge> collapsed{};
+            const auto                              projected = collapse(state.nextNode, reg, outcome, collapsed);
+            const auto                              factor    = std::sqrt(probabilities.at(outcome));
+            state = {projected.nextNode, complexNumber.lookup(valueOf(state.weight) * valueOf(projected.weight) / ComplexValue{factor, 0.})};
+            return outcome;
+        }
+
+    private:
+        // squared norms of the vectors of nodes, stored as the real part of a terminal edge
+        std::unique_ptr<UnaryComputeTable<vEdge, vCachedEdge, 4096>> subtreeNorms{std::make_unique<UnaryComputeTable<vEdge, vCachedEdge, 4096>>()};
+
+        // marginal distribution of a node with unit incoming weight over the selected registers at or below its level
+        const std::vector<fp>& marginalDistribution(vNode* node, const std::vector<std::pair<QuantumRegister, std::size_t>>& selected,
+                                                    std::unordered_map<const vNode*, std::vector<fp>>& distributions) {
+            const auto it = distributions.find(node);
+            if (it != distributions.end()) {
+                return it->second;
+            }
+            if (vNode::isTerminal(node) || node->varIndx < selected.front().first) {
+                return distributions.emplace(node, std::vector<fp>{subtreeNorm(node)}).first->second;
+            }
+
+            const auto  isSelected = std::binary_search(selected.begin(), selected.end(), std::make_pair(node->varIndx, std::size_t{0}),
+                                                        [](const auto& a, const auto& b) { return a.first < b.first; });
+            std::size_t childSize  = 1;
+            for (const auto& [reg, stride]: selected) {
+                if (reg < node->varIndx) {
+                    childSize *= registersSizes.at(static_cast<std::size_t>(reg));
+                }
+            }
+
+            std::vector<fp> distribution(isSelected ? node->edges.size() * childSize : childSize, 0.);
+            for (const auto i: node->nonZeroEdges) {
+                const auto& edge   = node->edges.at(i);
+                const auto& child  = marginalDistribution(edge.nextNode, selected, distributions);
+                const auto  p      = ComplexNumbers::mag2(edge.weight);
+                const auto  offset = isSelected ? i * childSize : 0U;
+                assert(child.size() == childSize);
+                for (std::size_t j = 0; j < childSize; ++j) {
+                    distribution.at(offset + j) += p * child.at(j);
+                }
+            }
+            return distributions.emplace(node, std::move(distribution)).first->second;
+        }
+
+        // project the vector of a node with unit incoming weight onto `outcome` of register `reg`
+        vEdge collapse(vNode* node, QuantumRegister reg, std::size_t outcome, std::unordered_map<const vNode*, vEdge>& collapsed) {
+            const auto it = collapsed.find(node);
+            if (it != collapsed.end()) {
+                return it->second;
+            }
+
+            std::vector<vEdge> edges(node->edges.size(), vEdge::zero);
+            if (node->varIndx == reg) {
+                edges.at(outcome) = node->edges.at(outcome);
+            } else {
+                for (const auto i: node->nonZeroEdges) {
+                    const auto& edge      = node->edges.at(i);
+                    const auto  projected = collapse(edge.nextNode, reg, outcome, collapsed);
+                    const auto  weight    = complexNumber.lookup(valueOf(edge.weight) * valueOf(projected.weight));
+                    if (weight != Complex::zero) {
+                        edges.at(i) = {projected.nextNode, weight};
+                    }
+                }
+            }
+
+            const auto result = makeDDNode(node->varIndx, edges);
+            collapsed.emplace(node, result);
+            return result;
+        }
+
+        template<class Generator>
+        void sample(vNode* node, std::size_t shots, std::vector<std::size_t>& digits, SampleCounts& counts,
+                    Generator& gen) {
+            if (vNode::isTerminal(node)) {
+                counts[digits] += shots;
+                return;
+            }
+
+            const auto reg           = static_cast<std::size_t>(node->varIndx);
+            auto       remainingNorm = subtreeNorm(node);
+            for (const auto i: node->nonZeroEdges) {
+                if (shots == 0) {
+                    break;
+                }
+                const auto& edge = node->edges.at(i);
+                const auto  norm = ComplexNumbers::mag2(edge.weight) * subtreeNorm(edge.nextNode);
+
+                // the last successor takes all remaining shots
+                auto successorShots = shots;
+                if (i != node->nonZeroEdges.back() && norm < remainingNorm) {
+                    std::binomial_distribution<std::size_t> distribution(shots, norm / remainingNorm);
+                    successorShots = distribution(gen);
+                }
+                remainingNorm -= norm;
+                shots -= successorShots;
+
+                if (successorShots > 0) {
+                    digits.at(reg) = i;
+                    sample(edge.nextNode, successorShots, digits, counts, gen);
+                }
+            }
+        }
+
+        ///
+        /// Density matrices
+        ///
+    public:
+        std::unique_ptr<ComputeTable<vEdge, vEdge, dCachedEdge>>               densityOuterProduct{std::make_unique<ComputeTable<vEdge, vEdge, dCachedEdge>>()};
+        std::unique_ptr<TernaryComputeTable<mEdge, dEdge, mEdge, dCachedEdge>> densityUnitary{std::make_unique<TernaryComputeTable<mEdge, dEdge, mEdge, dCachedEdge>>()};
+
+        // density matrix |state><state| of a pure state
+        dEdge makeDensityMatrix(const vEdge& state) {
+            if (state.nextNode == nullptr || state.weight.approximatelyZero()) {
+                return dEdge::zero;
+            }
+
+            const auto weight  = valueOf(state.weight);
+            const auto product = outerProduct(state.nextNode, state.nextNode);
+            return densityEdge(product.nextNode, weight * product.weight * conj(weight));
+        }
+
+        // op * rho * op^dagger computed in a single traversal without building op * rho
+        dEdge applyUnitary(const mEdge& op, const dEdge& rho) {
+            if (op.nextNode == nullptr || rho.nextNode == nullptr ||
+                op.weight.approximatelyZero() || rho.weight.approximatelyZero()) {
+                return dEdge::zero;
+            }
+            if (op.isTerminal() != rho.isTerminal() ||
+                (!op.isTerminal() && op.nextNode->varIndx != rho.nextNode->varIndx)) {
+                throw std::invalid_argument("Operator and density matrix have to act on the same registers.");
+            }
+
+            const auto weight  = valueOf(op.weight);
+            const auto product = conjugation(op.nextNode, rho.nextNode, op.nextNode);
+            return densityEdge(product.nextNode, weight * valueOf(rho.weight) * product.weight * conj(weight));
+        }
+
+        ComplexValue trace(const dEdge& rho) {
+            if (rho.nextNode == nullptr || rho.weight.approximatelyZero()) {
+                return {0., 0.};
+            }
+            std::unordered_map<const dNode*, ComplexValue> traces{};
+            return valueOf(rho.weight) * trace(rho.nextNode, traces);
+        }
+
+        // tr(rho^2), which for a hermitian rho is the sum of the squared magnitudes of its entries
+        fp purity(const dEdge& rho) {
+            if (rho.nextNode == nullptr || rho.weight.approximatelyZero()) {
+                return 0.;
+            }
+            std::unordered_map<const dNode*, fp> norms{};
+            return ComplexNumbers::mag2(rho.weight) * squaredNorm(rho.nextNode, norms);
+        }
+
+        // trace out the given registers. The remaining registers keep their order and are renumbered starting at 0,
+        // i.e., the result is the density matrix of a system consisting of the remaining registers only.
+        dEdge partialTrace(const dEdge& rho, const std::vector<QuantumRegister>& registers) {
+            if (rho.nextNode == nullptr || rho.weight.approximatelyZero()) {
+                return dEdge::zero;
+            }
+
+            const auto        levels = rho.isTerminal() ? 0U : static_cast<std::size_t>(rho.nextNode->varIndx) + 1U;
+            std::vector<bool> traced(levels, false);
+            for (const auto reg: registers) {
+                if (reg < 0 || static_cast<std::size_t>(reg) >= levels || traced.at(static_cast<std::size_t>(reg))) {
+                    throw std::invalid_argument("Registers to trace out have to be distinct registers of the density matrix.");
+                }
+                traced.at(static_cast<std::size_t>(reg)) = true;
+            }
+
+            std::unordered_map<const dNode*, dEdge> reduced{};
+            const auto                              result = partialTrace(rho.nextNode, traced, reduced);
+            return densityEdge(result.nextNode, valueOf(rho.weight) * valueOf(result.weight));
+        }
+
+    private:
+        // dimension of the register of a node, which differs from registersSizes after a partial trace
+        static std::size_t dimension(const dNode* node) {
+            return static_cast<std::size_t>(std::lround(std::sqrt(static_cast<fp>(node->edges.size()))));
+        }
+
+        dEdge densityEdge(dNode* node, const ComplexValue& weight) {
+            const auto c = complexNumber.lookup(weight);
+            if (c == Complex::zero) {
+                return dEdge::zero;
+            }
+            return {node, c};
+        }
+
+        // |ket><bra| for unit weights on both nodes
+        dCachedEdge outerProduct(vNode* ket, vNode* bra) {
+            assert(vNode::isTerminal(ket) == vNode::isTerminal(bra));
+            if (vNode::isTerminal(ket)) {
+                return {dNode::terminal, {1., 0.}};
+            }
+
+            const vEdge ketKey{ket, Complex::one};
+            const vEdge braKey{bra, Complex::one};
+            const auto  cached = densityOuterProduct->lookup(ketKey, braKey);
+            if (cached.nextNode != nullptr) {
+                return cached;
+            }
+
+            const auto         dim = ket->edges.size();
+            std::vector<dEdge> edges(dim * dim, dEdge::zero);
+            for (const auto i: ket->nonZeroEdges) {
+                const auto& ketEdge = ket->edges.at(i);
+                for (const auto j: bra->nonZeroEdges) {
+                    const auto& braEdge = bra->edges.at(j);
+                    const auto  product = outerProduct(ketEdge.nextNode, braEdge.nextNode);
+                    edges.at(i * dim + j) = densityEdge(product.nextNode, valueOf(ketEdge.weight) * product.weight * conj(valueOf(braEdge.weight)));
+                }
+            }
+
+            const auto        e = makeDDNode(ket->varIndx, edges);
+            const dCachedEdge result{e.nextNode, valueOf(e.weight)};
+            densityOuterProduct->insert(ketKey, braKey, result);
+            return result;
+        }
+
+        // left * rho * right^dagger for unit weights on the three nodes
+        dCachedEdge conjugation(mNode* left, dNode* rho, mNode* right) {
+            // DDs span all registers, so the terminals are reached simultaneously
+            if (dNode::isTerminal(rho)) {
+                return {dNode::terminal, {1., 0.}};
+            }
+            if (left == right && left->identity) {
+                return {rho, {1., 0.}};
+            }
+
+            const mEdge leftKey{left, Complex::one};
+            const dEdge rhoKey{rho, Complex::one};
+            const mEdge rightKey{right, Complex::one};
+            const auto  cached = densityUnitary->lookup(leftKey, rhoKey, rightKey);
+            if (cached.nextNode != nullptr) {
+                return cached;
+            }
+
+            const auto dim = dimension(rho);
+            assert(left->edges.size() == rho->edges.size() && right->edges.size() == rho->edges.size());
+            std::vector<dEdge> edges(rho->edges.size(), dEdge::zero);
+            if (left->blockIdentity && right->blockIdentity) {
+                // only the diagonal blocks of the operators contribute and block (i, j) only depends on rho(i, j)
+                const auto& leftEdge  = left->edges.front();
+                const auto& rightEdge = right->edges.front();
+                for (const auto idx: rho->nonZeroEdges) {
+                    const auto& rhoEdge = rho->edges.at(idx);
+                    const auto  product = conjugation(leftEdge.nextNode, rhoEdge.nextNode, rightEdge.nextNode);
+                    edges.at(idx)       = densityEdge(product.nextNode, valueOf(leftEdge.weight) * valueOf(rhoEdge.weight) *
+                                                                                product.weight * conj(valueOf(rightEdge.weight)));
+                }
+            } else {
+                // block (i, j) is the sum of left(i, k) * rho(k, l) * right(j, l)^dagger
+                for (const auto idx: rho->nonZeroEdges) {
+                    const auto  k       = idx / dim;
+                    const auto  l       = idx % dim;
+                    const auto& rhoEdge = rho->edges.at(idx);
+                    for (auto i = 0U; i < dim; ++i) {
+                        const auto& leftEdge = left->edges.at(i * dim + k);
+                        if (leftEdge.weight == Complex::zero) {
+                            continue;
+                        }
+                        for (auto j = 0U; j < dim; ++j) {
+                            const auto& rightEdge = right->edges.at(j * dim + l);
+                            if (rightEdge.weight == Complex::zero) {
+                                continue;
+                            }
+                            const auto product = conjugation(leftEdge.nextNode, rhoEdge.nextNode, rightEdge.nextNode);
+                            const auto term    = densityEdge(product.nextNode, valueOf(leftEdge.weight) * valueOf(rhoEdge.weight) *
+                                                                                       product.weight * conj(valueOf(rightEdge.weight)));
+                            edges.at(i * dim + j) = add(edges.at(i * dim + j), term);
+                        }
+                    }
+                }
+            }
+
+            const auto        e = makeDDNode(rho->varIndx, edges);
+            const dCachedEdge result{e.nextNode, valueOf(e.weight)};
+            densityUnitary->insert(leftKey, rhoKey, rightKey, result);
+            return result;
+        }
+
+        ComplexValue trace(const dNode* node, std::unordered_map<const dNode*, ComplexValue>& traces) {
+            if (dNode::isTerminal(node)) {
+                return {1., 0.};
+            }
+            const auto it = traces.find(node);
+            if (it != traces.end()) {
+                return it->second;
             }
 
-            auto xCopy   = x;
-            xCopy.weight = Complex::one;
-            auto yCopy   = y;
-            yCopy.weight = Complex::one;
+            const auto   dim = dimension(node);
+            ComplexValue sum{0., 0.};
+            for (auto i = 0U; i < dim; ++i) {
+                const auto& edge = node->edges.at(i * dim + i);
+                if (edge.weight != Complex::zero) {
+                    sum += valueOf(edge.weight) * trace(edge.nextNode, traces);
+                }
+            }
+            traces.emplace(node, sum);
+            return sum;
+        }
 
-            auto nodeLookup = vectorInnerProduct.lookup(xCopy, yCopy);
-            if (nodeLookup.nextNode != nullptr) {
-                auto c = complexNumber.getTemporary(nodeLookup.weight);
-                ComplexNumbers::mul(c, c, x.weight);
-                ComplexNumbers::mul(c, c, y.weight);
-                return {CTEntry::val(c.real), CTEntry::val(c.img)};
+        fp squaredNorm(const dNode* node, std::unordered_map<const dNode*, fp>& norms) {
+            if (dNode::isTerminal(node)) {
+                return 1.;
+            }
+            const auto it = norms.find(node);
+            if (it != norms.end()) {
+                return it->second;
             }
 
-            auto width = static_cast<QuantumRegister>(var - 1);
+            fp norm = 0.;
+            for (const auto i: node->nonZeroEdges) {
+                const auto& edge = node->edges.at(i);
+                norm += ComplexNumbers::mag2(edge.weight) * squaredNorm(edge.nextNode, norms);
+            }
+            norms.emplace(node, norm);
+            return norm;
+        }
 
-            ComplexValue sum{0.0, 0.0};
-            for (auto i = 0U; i < registersSizes.at(static_cast<std::size_t>(width)); i++) {
-                vEdge e1{};
-                if (!x.isTerminal() && x.nextNode->varIndx == width) {
-                    e1 = x.nextNode->edges.at(i);
-                } else {
-                    e1 = xCopy;
+        dEdge partialTrace(dNode* node, const std::vector<bool>& traced, std::unordered_map<const dNode*, dEdge>& reduced) {
+            if (dNode::isTerminal(node)) {
+                return dEdge::one;
+            }
+            const auto it = reduced.find(node);
+            if (it != reduced.end()) {
+                return it->second;
+            }
+
+            const auto level = static_cast<std::size_t>(node->varIndx);
+            auto       result = dEdge::zero;
+            if (traced.at(level)) {
+                const auto dim = dimension(node);
+                for (auto i = 0U; i < dim; ++i) {
+                    const auto& edge = node->edges.at(i * dim + i);
+                    if (edge.weight == Complex::zero) {
+                        continue;
+                    }
+                    const auto block = partialTrace(edge.nextNode, traced, reduced);
+                    result           = add(result, densityEdge(block.nextNode, valueOf(edge.weight) * valueOf(block.weight)));
                 }
-                vEdge e2{};
-                if (!y.isTerminal() && y.nextNode->varIndx == width) {
-                    e2        = y.nextNode->edges.at(i);
-                    e2.weight = ComplexNumbers::conj(e2.weight);
-                } else {
-                    e2 = yCopy;
+            } else {
+                std::vector<dEdge> edges(node->edges.size(), dEdge::zero);
+                for (const auto i: node->nonZeroEdges) {
+                    const auto& edge  = node->edges.at(i);
+                    const auto  block = partialTrace(edge.nextNode, traced, reduced);
+                    edges.at(i)       = densityEdge(block.nextNode, valueOf(edge.weight) * valueOf(block.weight));
                 }
-                auto cv = innerProduct(e1, e2, width);
-                sum.r += cv.r;
-                sum.i += cv.i;
+                const auto remaining = std::count(traced.begin(), traced.begin() + static_cast<std::ptrdiff_t>(level), false);
+                result               = makeDDNode(static_cast<QuantumRegister>(remaining), edges);
             }
-            nodeLookup.nextNode = vNode::terminal;
-            nodeLookup.weight   = sum;
+            reduced.emplace(node, result);
+            return result;
+        }
 
-            vectorInnerProduct.insert(xCopy, yCopy, nodeLookup);
-            auto c = complexNumber.getTemporary(sum);
-            ComplexNumbers::mul(c, c, x.weight);
-            ComplexNumbers::mul(c, c, y.weight);
-            return {CTEntry::val(c.real), CTEntry::val(c.img)};
+        ///
+        /// Stochastic noise trajectories
+        ///
+    public:
+        struct TrajectorySettings {
+            std::size_t   trajectories       = 1000;
+            std::size_t   shotsPerTrajectory = 1;
+            std::size_t   threads            = std::thread::hardware_concurrency();
+            std::uint64_t seed               = 0; // 0 draws a random seed
+        };
+
+        struct TrajectoryResult {
+            SampleCounts              counts{};            // samples of the final states of all trajectories
+            std::vector<ComplexValue> expectationValues{}; // mean over the trajectories for every observable
+        };
+
+        // Monte Carlo simulation of a noisy circuit. Every trajectory applies the operations to `initial` and draws
+        // the errors of `noise` after each of them. Trajectories run on the thread pool, each in a worker package
+        // sharing the tables of this one, and are seeded by their index, so results do not depend on the threads.
+        TrajectoryResult simulateTrajectories(const std::vector<Operation>& operations, const vEdge& initial,
+                                              const NoiseModel& noise, const std::vector<mEdge>& observables = {}) {
+            return simulateTrajectories(operations, initial, noise, observables, TrajectorySettings{});
+        }
+
+        TrajectoryResult simulateTrajectories(const std::vector<Operation>& operations, const vEdge& initial,
+                                              const NoiseModel& noise, const std::vector<mEdge>& observables,
+                                              TrajectorySettings settings) {
+            noise.validate();
+            if (settings.trajectories == 0) {
+                throw std::invalid_argument("Cannot simulate zero trajectories.");
+            }
+            if (settings.seed == 0) {
+                settings.seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32U) | std::random_device{}();
+            }
+
+            // everything the workers read is built upfront in the shared tables
+            const auto   n = static_cast<QuantumRegisterCount>(numberOfQuantumRegisters);
+            NoisyCircuit circuit{};
+            circuit.noise = noise;
+            for (const auto& op: operations) {
+                circuit.gates.push_back(makeOperationDD(op, n));
+                std::vector<QuantumRegister> registers(op.targets.begin(), op.targets.end());
+                for (const auto& control: op.controls) {
+                    registers.push_back(control.quantumRegister);
+                }
+                circuit.registers.push_back(std::move(registers));
+            }
+            prepareNoiseOperators(noise);
+            circuit.operators = &stochasticNoiseOperationCache;
+
+            const auto threads = std::max<std::size_t>(1U, std::min(settings.threads, settings.trajectories));
+            auto&      pool    = getThreadPool(threads);
+
+            std::vector<std::future<TrajectoryResult>> chunks{};
+            for (auto chunk = 0U; chunk < threads; ++chunk) {
+                const auto first = chunk * settings.trajectories / threads;
+                const auto last  = (chunk + 1) * settings.trajectories / threads;
+                chunks.push_back(pool.submit([this, &circuit, &initial, &observables, &settings, first, last]() {
+                    return workerPackages.at(ThreadPool::currentWorker())->runTrajectories(circuit, initial, observables, settings, first, last);
+                }));
+            }
+
+            TrajectoryResult result{};
+            result.expectationValues.assign(observables.size(), ComplexValue{0., 0.});
+            for (auto& chunk: chunks) {
+                const auto partial = chunk.get();
+                for (const auto& [outcome, count]: partial.counts) {
+                    result.counts[outcome] += count;
+                }
+                for (auto i = 0U; i < observables.size(); ++i) {
+                    result.expectationValues.at(i) += partial.expectationValues.at(i);
+                }
+            }
+            for (auto& value: result.expectationValues) {
+                value *= ComplexValue{1. / static_cast<fp>(settings.trajectories), 0.};
+            }
+            return result;
+        }
+
+    private:
+        // noise operators of a register: the generalized Pauli operators X^a Z^b at index a * d + b and the Kraus
+        // operators of the level decay, where decay[0] keeps the levels and decay[k] maps k to k - 1
+        struct NoiseOperators {
+            std::vector<mEdge> paulis{};
+            std::vector<mEdge> decay{};
+            fp                 decayProbability = -1.; // probability the decay operators were built for
+        };
+        std::vector<NoiseOperators> stochasticNoiseOperationCache{};
+
+        struct NoisyCircuit {
+            std::vector<mEdge>                        gates{};
+            std::vector<std::vector<QuantumRegister>> registers{}; // registers every gate acts on
+            NoiseModel                                noise{};
+            const std::vector<NoiseOperators>*        operators{};
+        };
+
+        void prepareNoiseOperators(const NoiseModel& noise) {
+            const auto n = static_cast<QuantumRegisterCount>(numberOfQuantumRegisters);
+            for (auto reg = 0U; reg < numberOfQuantumRegisters; ++reg) {
+                auto&      operators = stochasticNoiseOperationCache.at(reg);
+                const auto dim       = registersSizes.at(reg);
+                const auto target    = static_cast<QuantumRegister>(reg);
+
+                if ((noise.depolarization > 0. || noise.dephasing > 0.) && operators.paulis.empty()) {
+                    for (auto a = 0U; a < dim; ++a) {
+                        for (auto b = 0U; b < dim; ++b) {
+                            // X^a Z^b |k> = omega^(b k) |k + a>
+                            std::vector<ComplexValue> matrix(dim * dim, ComplexValue{0., 0.});
+                            for (auto k = 0U; k < dim; ++k) {
+                                const auto phase                           = 2. * PI * static_cast<fp>(b * k) / static_cast<fp>(dim);
+                                matrix.at(((k + a) % dim) * dim + k) = {std::cos(phase), std::sin(phase)};
+                            }
+                            operators.paulis.push_back(makeOperationDD({matrix, {target}, {}}, n));
+                        }
+                    }
+                }
+
+                if (noise.amplitudeDamping > 0. && operators.decayProbability != noise.amplitudeDamping) {
+                    operators.decay.clear();
+                    std::vector<ComplexValue> keep(dim * dim, ComplexValue{0., 0.});
+                    for (auto k = 0U; k < dim; ++k) {
+                        keep.at(k * dim + k) = {k == 0 ? 1. : std::sqrt(1. - noise.amplitudeDamping), 0.};
+                    }
+                    operators.decay.push_back(makeOperationDD({keep, {target}, {}}, n));
+                    for (auto k = 1U; k < dim; ++k) {
+                        std::vector<ComplexValue> decay(dim * dim, ComplexValue{0., 0.});
+                        decay.at((k - 1) * dim + k) = {std::sqrt(noise.amplitudeDamping), 0.};
+                        operators.decay.push_back(makeOperationDD({decay, {target}, {}}, n));
+                    }
+                    operators.decayProbability = noise.amplitudeDamping;
+                }
+            }
+        }
+
+        // run the trajectories [first, last) in this package
+        TrajectoryResult runTrajectories(const NoisyCircuit& circuit, const vEdge& initial, const std::vector<mEdge>& observables,
+                                         const TrajectorySettings& settings, std::size_t first, std::size_t last) {
+            TrajectoryResult result{};
+            result.expectationValues.assign(observables.size(), ComplexValue{0., 0.});
+            for (auto trajectory = first; trajectory < last; ++trajectory) {
+                std::seed_seq   sequence{static_cast<std::uint32_t>(settings.seed), static_cast<std::uint32_t>(settings.seed >> 32U),
+                                       static_cast<std::uint32_t>(trajectory), static_cast<std::uint32_t>(trajectory >> 32U)};
+                std::mt19937_64 gen(sequence);
+
+                auto state = initial;
+                for (auto i = 0U; i < circuit.gates.size(); ++i) {
+                    state = multiply(circuit.gates.at(i), state);
+                    if (!circuit.noise.isNoiseless()) {
+                        for (const auto reg: circuit.registers.at(i)) {
+                            state = applyNoise(circuit, reg, state, gen);
+                        }
+                    }
+                }
+
+                for (auto i = 0U; i < observables.size(); ++i) {
+                    result.expectationValues.at(i) += expectationValue(observables.at(i), state);
+                }
+                if (settings.shotsPerTrajectory > 0) {
+                    for (const auto& [outcome, count]: sample(state, settings.shotsPerTrajectory, gen)) {
+                        result.counts[outcome] += count;
+                    }
+                }
+            }
+            return result;
+        }
+
+        template<class Generator>
+        vEdge applyNoise(const NoisyCircuit& circuit, QuantumRegister reg, vEdge state, Generator& gen) {
+            const auto& noise     = circuit.noise;
+            const auto& operators = circuit.operators->at(static_cast<std::size_t>(reg));
+            const auto  dim       = registersSizes.at(static_cast<std::size_t>(reg));
+            if (dim == 0) {
+                throw std::invalid_argument("Cannot apply noise to register " + std::to_string(reg) + " without levels.");
+            }
+            if (dim < 2) {
+                // a single level admits no errors
+                return state;
+            }
+
+            std::uniform_real_distribution<fp> uniform(0., 1.);
+            if (noise.depolarization > 0. && uniform(gen) < noise.depolarization) {
+                std::uniform_int_distribution<std::size_t> error(1U, dim * dim - 1U);
+                state = multiply(operators.paulis.at(error(gen)), state);
+            }
+            if (noise.dephasing > 0. && uniform(gen) < noise.dephasing) {
+                std::uniform_int_distribution<std::size_t> power(1U, dim - 1U);
+                state = multiply(operators.paulis.at(power(gen)), state);
+            }
+            if (noise.amplitudeDamping > 0.) {
+                // decay of level k happens with probability amplitudeDamping * p(k)
+                const auto populations = measurementProbabilities(state, reg);
+                fp         noDecay     = std::accumulate(populations.begin(), populations.end(), 0.);
+                for (auto k = 1U; k < dim; ++k) {
+                    noDecay -= noise.amplitudeDamping * populations.at(k);
+                }
+                std::vector<fp> weights{std::max(noDecay, 0.)};
+                weights.reserve(dim);
+                for (auto k = 1U; k < dim; ++k) {
+                    weights.push_back(noise.amplitudeDamping * populations.at(k));
+                }
+
+                std::discrete_distribution<std::size_t> kraus(weights.begin(), weights.end());
+                const auto                              k       = kraus(gen);
+                const auto                              product = multiply(operators.decay.at(k), state);
+                state = {product.nextNode, complexNumber.lookup(valueOf(product.weight) / ComplexValue{std::sqrt(weights.at(k)), 0.})};
+            }
+            return state;
         }
 
         ///
@@ -1183,8 +3053,17 @@ namespace dd {
             //}
 
             std::vector<Edge<Node>> edge(x.nextNode->edges.size(), dd::Edge<Node>::zero);
-            for (auto i = 0U; i < x.nextNode->edges.size(); ++i) {
-                edge.at(i) = kronecker2(x.nextNode->edges.at(i), y, incIdx);
+            if (isBlockIdentity(x.nextNode)) {
+                // the diagonal successor is only tensored with y once
+                const auto basicDim = registersSizes.at(static_cast<std::size_t>(x.nextNode->varIndx));
+                const auto diagonal = kronecker2(x.nextNode->edges.front(), y, incIdx);
+                for (auto i = 0U; i < basicDim; ++i) {
+                    edge.at(i * basicDim + i) = (i == 0) ? diagonal : duplicateCached(diagonal);
+                }
+            } else {
+                for (const auto i: x.nextNode->nonZeroEdges) {
+                    edge.at(i) = kronecker2(x.nextNode->edges.at(i), y, incIdx);
+                }
             }
 
             auto idx = incIdx ? static_cast<QuantumRegister>(y.nextNode->varIndx + x.nextNode->varIndx + 1) : x.nextNode->varIndx;
@@ -1435,6 +3314,196 @@ namespace dd {
             return state;
         }
 
+        ///
+        /// Transfer of DDs between packages
+        ///
+    public:
+        // rebuild a DD owned by another package (with identical register sizes) inside this package
+        template<class Node>
+        Edge<Node> importDD(const Edge<Node>& e) {
+            std::unordered_map<const Node*, Edge<Node>> imported{};
+            return importEdge(e, imported);
+        }
+
+    private:
+        template<class Node>
+        Edge<Node> importEdge(const Edge<Node>& e, std::unordered_map<const Node*, Edge<Node>>& imported) {
+            if (e.weight.approximatelyZero()) {
+                return Edge<Node>::zero;
+            }
+
+            auto node = Edge<Node>::one;
+            if (!e.isTerminal()) {
+                auto it = imported.find(e.nextNode);
+                if (it != imported.end()) {
+                    node = it->second;
+                } else {
+                    std::vector<Edge<Node>> edges{};
+                    edges.reserve(e.nextNode->edges.size());
+                    for (const auto& child: e.nextNode->edges) {
+                        edges.push_back(importEdge(child, imported));
+                    }
+                    node = makeDDNode(e.nextNode->varIndx, edges);
+                    imported.emplace(e.nextNode, node);
+                }
+            }
+
+            const ComplexValue nodeWeight{CTEntry::val(node.weight.real), CTEntry::val(node.weight.img)};
+            const ComplexValue edgeWeight{CTEntry::val(e.weight.real), CTEntry::val(e.weight.img)};
+            auto               weight = complexNumber.lookup(nodeWeight * edgeWeight);
+            if (weight == Complex::zero) {
+                return Edge<Node>::zero;
+            }
+            return {node.nextNode, weight};
+        }
+
+        ///
+        /// Circuit unitaries
+        ///
+    public:
+        enum class UnitaryOrder {
+            Sequential, // left fold over the circuit
+            Balanced,   // balanced binary tree over the circuit
+            SizeAware   // repeatedly combine the adjacent pair of partial products with the fewest nodes
+        };
+
+        struct UnitaryStatistics {
+            std::size_t multiplications{};
+            std::size_t peakIntermediateNodes{}; // size of the largest partial product
+            std::size_t uniqueTableNodes{};      // matrix nodes created during construction
+            double      seconds{};               // wall time
+        };
+
+        mEdge buildUnitary(const std::vector<Operation>& operations,
+                           UnitaryOrder order = UnitaryOrder::Balanced, std::size_t threads = 1) {
+            UnitaryStatistics statistics{};
+            return buildUnitary(operations, statistics, order, threads);
+        }
+
+        // build the unitary of a circuit. With more than one thread, the balanced order splits the circuit into
+        // contiguous slices whose products are built concurrently in packages sharing the tables of this one.
+        mEdge buildUnitary(const std::vector<Operation>& operations, UnitaryStatistics& statistics,
+                           UnitaryOrder order = UnitaryOrder::Balanced, std::size_t threads = 1) {
+            const auto begin       = std::chrono::steady_clock::now();
+            const auto nodesBefore = mUniqueTable.getNodeCount();
+            statistics             = {};
+
+            const auto n = static_cast<QuantumRegisterCount>(numberOfQuantumRegisters);
+
+            mEdge result{};
+            if (operations.empty()) {
+                result = makeIdent(n);
+            } else if (threads > 1 && order == UnitaryOrder::Balanced && operations.size() > 1) {
+                result = buildUnitaryConcurrently(operations, statistics, threads);
+            } else {
+                std::vector<mEdge> gates{};
+                gates.reserve(operations.size());
+                for (const auto& op: operations) {
+                    gates.push_back(makeOperationDD(op, n));
+                }
+                result = combineGates(gates, statistics, order);
+            }
+
+            statistics.uniqueTableNodes += mUniqueTable.getNodeCount() - nodesBefore;
+            statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            return result;
+        }
+
+    private:
+        // multiply gates[0] first, i.e., the result is gates[k-1] * ... * gates[0]
+        mEdge combineGates(std::vector<mEdge> gates, UnitaryStatistics& statistics, UnitaryOrder order) {
+            auto countNodes = [this](const mEdge& e) {
+                std::unordered_set<mNode*> visited{};
+                return static_cast<std::size_t>(nodeCount(e, visited));
+            };
+            auto combine = [&](const mEdge& later, const mEdge& earlier) {
+                auto product = multiply(later, earlier);
+                statistics.multiplications++;
+                statistics.peakIntermediateNodes = std::max(statistics.peakIntermediateNodes, countNodes(product));
+                return product;
+            };
+
+            switch (order) {
+                case UnitaryOrder::Sequential: {
+                    auto product = gates.front();
+                    for (auto i = 1U; i < gates.size(); ++i) {
+                        product = combine(gates.at(i), product);
+                    }
+                    return product;
+                }
+                case UnitaryOrder::Balanced: {
+                    while (gates.size() > 1) {
+                        std::vector<mEdge> next{};
+                        next.reserve((gates.size() + 1) / 2);
+                        for (auto i = 0U; i + 1 < gates.size(); i += 2) {
+                            next.push_back(combine(gates.at(i + 1), gates.at(i)));
+                        }
+                        if (gates.size() % 2 == 1) {
+                            next.push_back(gates.back());
+                        }
+                        gates = std::move(next);
+                    }
+                    return gates.front();
+                }
+                case UnitaryOrder::SizeAware: {
+                    std::vector<std::size_t> sizes{};
+                    sizes.reserve(gates.size());
+                    for (const auto& gate: gates) {
+                        sizes.push_back(countNodes(gate));
+                    }
+                    while (gates.size() > 1) {
+                        auto cheapest = 0U;
+                        for (auto i = 1U; i + 1 < gates.size(); ++i) {
+                            if (sizes.at(i) + sizes.at(i + 1) < sizes.at(cheapest) + sizes.at(cheapest + 1)) {
+                                cheapest = i;
+                            }
+                        }
+                        gates.at(cheapest) = combine(gates.at(cheapest + 1), gates.at(cheapest));
+                        sizes.at(cheapest) = countNodes(gates.at(cheapest));
+                        gates.erase(gates.begin() + static_cast<std::ptrdiff_t>(cheapest + 1));
+                        sizes.erase(sizes.begin() + static_cast<std::ptrdiff_t>(cheapest + 1));
+                    }
+                    return gates.front();
+                }
+            }
+            throw std::invalid_argument("Unknown unitary construction order.");
+        }
+
+        mEdge buildUnitaryConcurrently(const std::vector<Operation>& operations, UnitaryStatistics& statistics,
+                                       std::size_t threads) {
+            const auto slices = std::min(threads, operations.size());
+
+            // all packages are set up before the first one starts working in the shared tables
+            std::vector<std::unique_ptr<MDDPackage>> workers{};
+            for (auto slice = 0U; slice < slices; ++slice) {
+                workers.push_back(std::make_unique<MDDPackage>(*this, SharedTables{}));
+            }
+
+            std::vector<UnitaryStatistics>  workerStatistics(slices);
+            std::vector<std::future<mEdge>> partialProducts{};
+            for (auto slice = 0U; slice < slices; ++slice) {
+                const auto first = operations.begin() + static_cast<std::ptrdiff_t>(slice * operations.size() / slices);
+                const auto last  = operations.begin() + static_cast<std::ptrdiff_t>((slice + 1) * operations.size() / slices);
+
+                partialProducts.push_back(std::async(std::launch::async,
+                                                     [&worker = *workers.at(slice), &sliceStatistics = workerStatistics.at(slice), first, last]() {
+                                                         return worker.buildUnitary(std::vector<Operation>(first, last), sliceStatistics);
+                                                     }));
+            }
+
+            std::vector<mEdge> gates{};
+            gates.reserve(slices);
+            for (auto slice = 0U; slice < slices; ++slice) {
+                gates.push_back(partialProducts.at(slice).get());
+
+                // nodes created by the slices are counted in the shared table
+                const auto& sliceStatistics = workerStatistics.at(slice);
+                statistics.multiplications += sliceStatistics.multiplications;
+                statistics.peakIntermediateNodes = std::max(statistics.peakIntermediateNodes, sliceStatistics.peakIntermediateNodes);
+            }
+            return combineGates(gates, statistics, UnitaryOrder::Balanced);
+        }
+
     public:
         template<class Edge>
         unsigned int nodeCount(const Edge& e, std::unordered_set<decltype(e.nextNode)>& v) const {
@@ -1447,7 +3516,287 @@ namespace dd {
                     }
                 }
             }
-            return sum;
+            return sum;
+        }
+
+        ///
+        /// Dynamic register reordering
+        ///
+    public:
+        struct ReorderingSettings {
+            std::size_t threshold = 0;   // node count of the DDs that triggers sifting, 0 disables it
+            fp          growth    = 2.;  // the next threshold is this factor times the node count after sifting
+            fp          maxGrowth = 1.2; // a register stops moving in one direction once the DDs grow beyond this
+                                         // factor times the smallest node count seen
+        };
+
+        // level holding a logical register and vice versa. Registers of gates and controls have to be given as
+        // levels, i.e., translated by physicalRegister once the DDs have been reordered.
+        [[nodiscard]] QuantumRegister physicalRegister(QuantumRegister logical) const {
+            const auto it = std::find(logicalRegisters.begin(), logicalRegisters.end(), logical);
+            if (it == logicalRegisters.end()) {
+                throw std::invalid_argument("Unknown logical register " + std::to_string(logical) + ".");
+            }
+            return static_cast<QuantumRegister>(it - logicalRegisters.begin());
+        }
+
+        [[nodiscard]] QuantumRegister logicalRegister(QuantumRegister physical) const {
+            return logicalRegisters.at(static_cast<std::size_t>(physical));
+        }
+
+        [[nodiscard]] Controls physicalControls(const Controls& controls) const {
+            Controls physical{};
+            for (const auto& control: controls) {
+                physical.insert({physicalRegister(control.quantumRegister), control.type});
+            }
+            return physical;
+        }
+
+        // exchange the registers of the levels `level` and `level + 1`. The dimensions of both levels are exchanged
+        // as well, so every DD used afterwards has to be passed and is replaced by its counterpart in the new order.
+        void swapLevels(QuantumRegister level, std::vector<vEdge>& states, std::vector<mEdge>& operators) {
+            if (level < 0 || static_cast<std::size_t>(level) + 1 >= numberOfQuantumRegisters) {
+                throw std::invalid_argument("Cannot swap level " + std::to_string(level) + " with the level above.");
+            }
+            const auto lower = static_cast<std::size_t>(level);
+            std::swap(registersSizes.at(lower), registersSizes.at(lower + 1));
+            std::swap(logicalRegisters.at(lower), logicalRegisters.at(lower + 1));
+
+            // identities spanning the swapped levels and all noise operators, which are built over every level,
+            // refer to the old dimensions
+            std::fill(idTable.begin() + static_cast<std::ptrdiff_t>(lower), idTable.end(), mEdge{});
+            std::fill(stochasticNoiseOperationCache.begin(), stochasticNoiseOperationCache.end(), NoiseOperators{});
+
+            std::unordered_map<vNode*, vEdge> swappedStates{};
+            for (auto& state: states) {
+                state = swapAdjacentLevels(state, level, swappedStates);
+            }
+            std::unordered_map<mNode*, mEdge> swappedOperators{};
+            for (auto& op: operators) {
+                op = swapAdjacentLevels(op, level, swappedOperators);
+            }
+        }
+
+        void swapLevels(QuantumRegister level, std::vector<vEdge>& states) {
+            std::vector<mEdge> operators{};
+            swapLevels(level, states, operators);
+        }
+
+        // number of distinct nodes of the DDs including the terminal
+        [[nodiscard]] std::size_t nodeCount(const std::vector<vEdge>& states, const std::vector<mEdge>& operators) const {
+            std::size_t                count = 0;
+            std::unordered_set<vNode*> visitedStates{};
+            for (const auto& state: states) {
+                if (visitedStates.count(state.nextNode) == 0) {
+                    count += nodeCount(state, visitedStates);
+                }
+            }
+            std::unordered_set<mNode*> visitedOperators{};
+            for (const auto& op: operators) {
+                if (visitedOperators.count(op.nextNode) == 0) {
+                    count += nodeCount(op, visitedOperators);
+                }
+            }
+            return count;
+        }
+
+        // sifting: every register, starting with the ones of the widest levels, is moved through all levels by
+        // adjacent swaps and left at the level where the DDs have the fewest nodes. Returns that node count.
+        // Nodes are never collected, so the nodes replaced by every swap stay in the unique table, which grows
+        // with each sift by up to the number of swaps times the size of the DDs.
+        std::size_t sift(std::vector<vEdge>& states, std::vector<mEdge>& operators) {
+            auto nodes = nodeCount(states, operators);
+            auto best  = nodes;
+            if (numberOfQuantumRegisters < 2) {
+                return best;
+            }
+
+            // a swap only changes the widths of the two swapped levels, so only those are recounted
+            auto       widths = levelWidths(states, operators);
+            const auto swap   = [this, &states, &operators, &nodes, &widths](QuantumRegister lower) {
+                swapLevels(lower, states, operators);
+                const auto updated = levelWidths(states, operators, lower);
+                for (const auto l: {static_cast<std::size_t>(lower), static_cast<std::size_t>(lower) + 1}) {
+                    nodes        = nodes - widths.at(l) + updated.at(l);
+                    widths.at(l) = updated.at(l);
+                }
+            };
+
+            std::vector<QuantumRegister> registers(logicalRegisters);
+            std::stable_sort(registers.begin(), registers.end(), [this, &widths](QuantumRegister a, QuantumRegister b) {
+                return widths.at(static_cast<std::size_t>(physicalRegister(a))) > widths.at(static_cast<std::size_t>(physicalRegister(b)));
+            });
+
+            const auto top = static_cast<QuantumRegister>(numberOfQuantumRegisters - 1);
+            for (const auto reg: registers) {
+                auto level     = physicalRegister(reg);
+                auto bestLevel = level;
+
+                // move towards the closer end first
+                const bool downFirst = level <= top - level;
+                for (const auto down: {downFirst, !downFirst}) {
+                    while (down ? level > 0 : level < top) {
+                        swap(down ? static_cast<QuantumRegister>(level - 1) : level);
+                        level = down ? static_cast<QuantumRegister>(level - 1) : static_cast<QuantumRegister>(level + 1);
+                        if (nodes < best) {
+                            best      = nodes;
+                            bestLevel = level;
+                        } else if (static_cast<fp>(nodes) > reorderingSettings.maxGrowth * static_cast<fp>(best)) {
+                            break;
+                        }
+                    }
+                }
+                for (; level > bestLevel; --level) {
+                    swap(static_cast<QuantumRegister>(level - 1));
+                }
+                for (; level < bestLevel; ++level) {
+                    swap(level);
+                }
+            }
+            return best;
+        }
+
+        std::size_t sift(std::vector<vEdge>& states) {
+            std::vector<mEdge> operators{};
+            return sift(states, operators);
+        }
+
+        void setReorderingSettings(const ReorderingSettings& settings) {
+            if (settings.growth < 1. || settings.maxGrowth < 1.) {
+                throw std::invalid_argument("Growth factors of the reordering have to be at least 1.");
+            }
+            reorderingSettings  = settings;
+            reorderingThreshold = settings.threshold;
+        }
+
+        [[nodiscard]] const ReorderingSettings& getReorderingSettings() const { return reorderingSettings; }
+
+        // sift the DDs if automatic reordering is enabled and their node count crossed the threshold, which then
+        // grows with the node count after sifting. Returns whether the DDs have been reordered. Like every sift,
+        // a reordering leaves the replaced nodes in the unique table.
+        bool reorderIfNeeded(std::vector<vEdge>& states, std::vector<mEdge>& operators) {
+            if (reorderingThreshold == 0 || nodeCount(states, operators) < reorderingThreshold) {
+                return false;
+            }
+            const auto nodes    = sift(states, operators);
+            reorderingThreshold = std::max(reorderingThreshold, static_cast<std::size_t>(reorderingSettings.growth * static_cast<fp>(nodes)));
+            return true;
+        }
+
+        bool reorderIfNeeded(std::vector<vEdge>& states) {
+            std::vector<mEdge> operators{};
+            return reorderIfNeeded(states, operators);
+        }
+
+    private:
+        ReorderingSettings reorderingSettings{};
+        std::size_t        reorderingThreshold = 0;
+
+        // DD of edge with the levels `level` and `level + 1` exchanged. registersSizes already holds the new
+        // dimensions. Nodes below the swapped levels are kept, the ones above are rebuilt.
+        template<class Node>
+        Edge<Node> swapAdjacentLevels(const Edge<Node>& edge, QuantumRegister level, std::unordered_map<Node*, Edge<Node>>& memo) {
+            if (edge.isTerminal() || edge.weight == Complex::zero || edge.nextNode->varIndx <= level) {
+                return edge;
+            }
+
+            auto it = memo.find(edge.nextNode);
+            if (it == memo.end()) {
+                const auto* node = edge.nextNode;
+                Edge<Node>  swapped{};
+                if (node->varIndx > level + 1) {
+                    std::vector<Edge<Node>> edges(node->edges.size(), Edge<Node>::zero);
+                    for (const auto i: node->nonZeroEdges) {
+                        edges.at(i) = swapAdjacentLevels(node->edges.at(i), level, memo);
+                    }
+                    swapped = makeBlockNode(node->varIndx, edges);
+                } else {
+                    swapped = swapNode(node, level);
+                }
+                it = memo.emplace(edge.nextNode, swapped).first;
+            }
+
+            const auto& swapped = it->second;
+            if (swapped.weight == Complex::zero) {
+                return Edge<Node>::zero;
+            }
+            const auto weight = complexNumber.lookup(valueOf(swapped.weight) * valueOf(edge.weight));
+            if (weight == Complex::zero) {
+                return Edge<Node>::zero;
+            }
+            return {swapped.nextNode, weight};
+        }
+
+        // node of level `level + 1` rebuilt with its two levels exchanged: the successor (u, l) of the new upper
+        // level is the successor (l, u) of the old one with the weights of both old edges multiplied
+        template<class Node>
+        Edge<Node> swapNode(const Node* node, QuantumRegister level) {
+            constexpr bool isVector  = std::is_same_v<Node, vNode>;
+            const auto     upperDim  = registersSizes.at(static_cast<std::size_t>(level) + 1); // old lower dimension
+            const auto     lowerDim  = registersSizes.at(static_cast<std::size_t>(level));     // old upper dimension
+            const auto     index     = [](std::size_t row, std::size_t col, std::size_t dim) { return isVector ? row : row * dim + col; };
+            const auto     upperCols = isVector ? 1U : upperDim;
+            const auto     lowerCols = isVector ? 1U : lowerDim;
+
+            std::vector<std::vector<Edge<Node>>> successors(upperDim * upperCols, std::vector<Edge<Node>>(lowerDim * lowerCols, Edge<Node>::zero));
+            for (auto p = 0U; p < lowerDim; ++p) {
+                for (auto q = 0U; q < lowerCols; ++q) {
+                    const auto& outer = node->edges.at(index(p, q, lowerDim));
+                    if (outer.weight == Complex::zero) {
+                        continue;
+                    }
+                    assert(!outer.isTerminal() && outer.nextNode->varIndx == level);
+                    for (auto r = 0U; r < upperDim; ++r) {
+                        for (auto c = 0U; c < upperCols; ++c) {
+                            const auto& inner = outer.nextNode->edges.at(index(r, c, upperDim));
+                            if (inner.weight == Complex::zero) {
+                                continue;
+                            }
+                            const auto weight = complexNumber.lookup(valueOf(outer.weight) * valueOf(inner.weight));
+                            if (weight != Complex::zero) {
+                                successors.at(index(r, c, upperDim)).at(index(p, q, lowerDim)) = {inner.nextNode, weight};
+                            }
+                        }
+                    }
+                }
+            }
+
+            std::vector<Edge<Node>> edges(successors.size(), Edge<Node>::zero);
+            for (auto i = 0U; i < successors.size(); ++i) {
+                edges.at(i) = makeBlockNode(level, successors.at(i));
+            }
+            return makeBlockNode(static_cast<QuantumRegister>(level + 1), edges);
+        }
+
+        // number of nodes of the DDs on every level from `lowest` up. Levels below are neither counted nor visited.
+        std::vector<std::size_t> levelWidths(const std::vector<vEdge>& states, const std::vector<mEdge>& operators,
+                                             QuantumRegister lowest = 0) const {
+            std::vector<std::size_t> widths(numberOfQuantumRegisters, 0U);
+            const auto               count = [&widths, lowest](const auto& roots) {
+                using NodePointer = decltype(roots.front().nextNode);
+                std::unordered_set<NodePointer> visited{};
+                std::vector<NodePointer>        stack{};
+                for (const auto& root: roots) {
+                    stack.push_back(root.nextNode);
+                }
+                while (!stack.empty()) {
+                    auto* node = stack.back();
+                    stack.pop_back();
+                    if (node->varIndx < lowest || !visited.insert(node).second) {
+                        continue;
+                    }
+                    ++widths.at(static_cast<std::size_t>(node->varIndx));
+                    if (node->varIndx == lowest) {
+                        continue;
+                    }
+                    for (const auto i: node->nonZeroEdges) {
+                        stack.push_back(node->edges.at(i).nextNode);
+                    }
+                }
+            };
+            count(states);
+            count(operators);
+            return widths;
         }
 
         ///
@@ -1486,76 +3835,145 @@ namespace dd {
             return {CTEntry::val(tempCompNumb.real), CTEntry::val(tempCompNumb.img)};
         }
 
-        ComplexValue getValueByPath(const vEdge& edge, std::vector<std::size_t>& reprI) {
-            if (edge.isTerminal()) {
-                return {CTEntry::val(edge.weight.real), CTEntry::val(edge.weight.img)};
-            }
+        // the paths list the successor to follow for every level, starting at the root
+        ComplexValue getValueByPath(const vEdge& edge, const std::vector<std::size_t>& reprI) {
             return getValueByPath(edge, Complex::one, reprI);
         }
 
-        ComplexValue getValueByPath(const vEdge& edge, const Complex& amp, std::vector<std::size_t>& repr) {
-            auto cNumb = complexNumber.mulCached(edge.weight, amp);
+        ComplexValue getValueByPath(const vEdge& edge, const Complex& amp, const std::vector<std::size_t>& repr) {
+            auto        value   = valueOf(amp) * valueOf(edge.weight);
+            auto        current = edge;
+            std::size_t depth   = 0;
+            while (!current.isTerminal()) {
+                current = current.nextNode->edges.at(repr.at(depth++));
+                if (current.weight.approximatelyZero()) {
+                    return {0., 0.};
+                }
+                value *= valueOf(current.weight);
+            }
+            return value;
+        }
 
-            if (edge.isTerminal()) {
-                complexNumber.returnToCache(cNumb);
-                return {CTEntry::val(cNumb.real), CTEntry::val(cNumb.img)};
+        ComplexValue getValueByPath(const mEdge&                    edge,
+                                    const std::vector<std::size_t>& reprI,
+                                    const std::vector<std::size_t>& reprJ) {
+            return getValueByPath(edge, Complex::one, reprI, reprJ);
+        }
+
+        ComplexValue getValueByPath(const mEdge& edge, const Complex& amp,
+                                    const std::vector<std::size_t>& reprI,
+                                    const std::vector<std::size_t>& reprJ) {
+            // row major encoding
+            auto        value   = valueOf(amp) * valueOf(edge.weight);
+            auto        current = edge;
+            std::size_t depth   = 0;
+            while (!current.isTerminal()) {
+                const auto basicDim = registersSizes.at(static_cast<std::size_t>(current.nextNode->varIndx));
+                current             = current.nextNode->edges.at(reprI.at(depth) * basicDim + reprJ.at(depth));
+                ++depth;
+                if (current.weight.approximatelyZero()) {
+                    return {0., 0.};
+                }
+                value *= valueOf(current.weight);
             }
+            return value;
+        }
 
-            ComplexValue returnAmp{};
+        // amplitudes of the given indices, in the order of the request. The indices are sorted, so every node on
+        // the paths to them is visited once and shared prefixes are multiplied only once.
+        std::vector<ComplexValue> getAmplitudes(const vEdge& edge, const std::vector<std::size_t>& indices) const {
+            const auto dim = stateDimension();
+            for (const auto index: indices) {
+                if (index >= dim) {
+                    throw std::invalid_argument("Index " + std::to_string(index) + " exceeds the dimension of the state.");
+                }
+            }
 
-            if (!edge.nextNode->edges.at(repr.front()).weight.approximatelyZero()) {
-                std::vector<std::size_t> reprSlice(repr.begin() + 1, repr.end());
-                returnAmp = getValueByPath(edge.nextNode->edges.at(repr.front()), cNumb,
-                                           reprSlice);
+            // pairs of index and position in the request
+            std::vector<std::pair<std::size_t, std::size_t>> requests{};
+            requests.reserve(indices.size());
+            for (std::size_t i = 0; i < indices.size(); ++i) {
+                requests.emplace_back(indices[i], i);
+            }
+            if (!std::is_sorted(indices.begin(), indices.end())) {
+                std::sort(requests.begin(), requests.end());
             }
 
-            complexNumber.returnToCache(cNumb);
-            return returnAmp;
+            std::vector<ComplexValue> amplitudes(indices.size(), ComplexValue{0., 0.});
+            collectAmplitudes(edge, {1., 0.}, 0, dim, requests.cbegin(), requests.cend(), amplitudes);
+            return amplitudes;
         }
 
-        ComplexValue getValueByPath(const mEdge&              edge,
-                                    std::vector<std::size_t>& reprI,
-                                    std::vector<std::size_t>& reprJ) {
-            if (edge.isTerminal()) {
-                return {CTEntry::val(edge.weight.real), CTEntry::val(edge.weight.img)};
+        // number of amplitudes of a state of all registers
+        [[nodiscard]] std::size_t stateDimension() const {
+            std::size_t dim = 1U;
+            for (const auto registersSize: registersSizes) {
+                if (registersSize != 0 && dim > std::numeric_limits<std::size_t>::max() / registersSize) {
+                    throw std::overflow_error("The dimension of the state exceeds the range of std::size_t.");
+                }
+                dim *= registersSize;
             }
-            return getValueByPath(edge, Complex::one, reprI, reprJ);
+            return dim;
         }
 
-        ComplexValue getValueByPath(const mEdge& edge, const Complex& amp,
-                                    std::vector<std::size_t>& reprI,
-                                    std::vector<std::size_t>& reprJ) {
-            // row major encoding
-
-            auto cNumb = complexNumber.mulCached(edge.weight, amp);
+        CVec getVector(const vEdge& edge, std::size_t threads = 1) {
+            auto vec = CVec(stateDimension());
+            getVector(edge, vec.data(), vec.size(), threads);
+            return vec;
+        }
 
-            if (edge.isTerminal()) {
-                complexNumber.returnToCache(cNumb);
-                return {CTEntry::val(cNumb.real), CTEntry::val(cNumb.img)};
+        // write the whole vector into a caller-provided buffer of `size` entries, e.g., a memory-mapped file.
+        // With more than one thread, contiguous index ranges are extracted concurrently.
+        void getVector(const vEdge& edge, std::complex<fp>* buffer, std::size_t size, std::size_t threads = 1) {
+            const auto dim = stateDimension();
+            if (size != dim) {
+                throw std::invalid_argument("Buffer has " + std::to_string(size) + " entries, but the state has " +
+                                            std::to_string(dim) + ".");
+            }
+            threads = std::max<std::size_t>(1U, std::min(threads, dim));
+            if (threads == 1) {
+                getVectorRange(edge, 0, dim, buffer);
+                return;
             }
 
-            const auto   row           = reprI.front();
-            const auto   col           = reprJ.front();
-            const auto   rowMajorIndex = row * edge.nextNode->edges.size() + col;
-            ComplexValue returnAmp{};
+            auto&                          pool = getThreadPool(threads);
+            std::vector<std::future<void>> chunks{};
+            for (auto chunk = 0U; chunk < threads; ++chunk) {
+                const auto first = dim / threads * chunk + std::min<std::size_t>(chunk, dim % threads);
+                const auto count = dim / threads + (chunk < dim % threads ? 1U : 0U);
+                chunks.push_back(pool.submit([this, &edge, first, count, buffer]() {
+                    getVectorRange(edge, first, count, buffer + first);
+                }));
+            }
+            for (auto& chunk: chunks) {
+                chunk.get();
+            }
+        }
 
-            if (!edge.nextNode->edges.at(rowMajorIndex).weight.approximatelyZero()) {
-                std::vector<std::size_t> reprSliceI(reprI.begin() + 1, reprI.end());
-                std::vector<std::size_t> reprSliceJ(reprJ.begin() + 1, reprJ.end());
-                returnAmp = getValueByPath(edge.nextNode->edges.at(rowMajorIndex), cNumb,
-                                           reprSliceI, reprSliceJ);
+        // write the amplitudes with indices in [first, first + count) to `buffer`. Only the paths leading into the
+        // range are traversed and the DD is not modified, so disjoint ranges may be extracted concurrently.
+        void getVectorRange(const vEdge& edge, std::size_t first, std::size_t count, std::complex<fp>* buffer) const {
+            const auto dim = stateDimension();
+            if (first > dim || count > dim - first) {
+                throw std::invalid_argument("Requested amplitudes exceed the dimension of the state.");
             }
-            complexNumber.returnToCache(cNumb);
-            return returnAmp;
+            extractAmplitudes(edge, {1., 0.}, 0, dim, first, first + count, buffer);
         }
 
-        CVec getVector(const vEdge& edge) {
-            const auto dim = static_cast<const size_t>(std::accumulate(
-                    registersSizes.begin(), registersSizes.end(), 1, std::multiplies<>()));
-            // allocate resulting vector
-            auto vec = CVec(dim, {0.0, 0.0});
-            getVector(edge, Complex::one, 0, vec, dim);
-            return vec;
+        // pass the vector to `consumer` in consecutive chunks of at most `chunkSize` amplitudes, which reuse a
+        // single buffer. The consumer is called with the index of the first amplitude, the data and its length.
+        template<class Consumer>
+        void streamVector(const vEdge& edge, std::size_t chunkSize, Consumer&& consumer) const {
+            if (chunkSize == 0) {
+                throw std::invalid_argument("Chunks must not be empty.");
+            }
+            const auto dim = stateDimension();
+            CVec       chunk(std::min(chunkSize, dim));
+            for (std::size_t first = 0; first < dim; first += chunk.size()) {
+                const auto count = std::min(chunk.size(), dim - first);
+                getVectorRange(edge, first, count, chunk.data());
+                consumer(first, static_cast<const std::complex<fp>*>(chunk.data()), count);
+            }
         }
 
         CVec getVectorizedMatrix(const mEdge& edge) {
@@ -1570,20 +3988,15 @@ namespace dd {
             return vec;
         }
 
+        // write the entries of the DD in the order of its successors, i.e., for matrices the successors of every
+        // level are enumerated in row-major order. `vec` has to be zero-initialized.
         template<class Node>
-        void getVector(const Edge<Node>& edge, const Complex& amp, std::size_t i, CVec& vec, std::size_t next, std::vector<std::size_t> pathTracker = {}) {
+        void getVector(const Edge<Node>& edge, const Complex& amp, std::size_t i, CVec& vec, std::size_t next) {
             // calculate new accumulated amplitude
             auto cNumb = complexNumber.mulCached(edge.weight, amp);
 
             // base case
             if (edge.isTerminal()) {
-                if (std::is_same<Node, mNode>::value) {
-                    for (const auto j: pathTracker) {
-                        std::cout << j;
-                    }
-                    std::cout << ": ";
-                    std::cout << cNumb << std::endl;
-                }
                 vec.at(i) = {CTEntry::val(cNumb.real), CTEntry::val(cNumb.img)};
                 complexNumber.returnToCache(cNumb);
                 return;
@@ -1591,23 +4004,226 @@ namespace dd {
 
             auto offset = (next - i) / edge.nextNode->edges.size();
 
-            for (auto k = 0UL; k < edge.nextNode->edges.size(); k++) {
-                if (std::is_same<Node, mNode>::value) {
-                    pathTracker.push_back(k);
+            for (const auto k: edge.nextNode->nonZeroEdges) {
+                if (!edge.nextNode->edges.at(k).weight.approximatelyZero()) {
                     getVector(edge.nextNode->edges.at(k), cNumb, i + (k * offset), vec,
-                              i + ((k + 1) * offset), pathTracker);
-                    pathTracker.pop_back();
-                } else {
-                    if (!edge.nextNode->edges.at(k).weight.approximatelyZero()) {
-                        getVector(edge.nextNode->edges.at(k), cNumb, i + (k * offset), vec,
-                                  i + ((k + 1) * offset));
-                    }
+                              i + ((k + 1) * offset));
                 }
             }
 
             complexNumber.returnToCache(cNumb);
         }
 
+        CMat getMatrix(const mEdge& edge, std::size_t threads = 1) {
+            const auto dim = stateDimension();
+            CVec       buffer(checkedSquare(dim));
+            getMatrix(edge, buffer.data(), buffer.size(), threads);
+
+            CMat matrix(dim);
+            for (std::size_t row = 0; row < dim; ++row) {
+                const auto rowBegin = buffer.begin() + static_cast<std::ptrdiff_t>(row * dim);
+                matrix.at(row).assign(rowBegin, rowBegin + static_cast<std::ptrdiff_t>(dim));
+            }
+            return matrix;
+        }
+
+        // write the matrix in row-major order into a caller-provided buffer of `size` entries. With more than one
+        // thread, the matrix is split into tiles along the top levels of the DD that are extracted concurrently.
+        void getMatrix(const mEdge& edge, std::complex<fp>* buffer, std::size_t size, std::size_t threads = 1) {
+            const auto dim = stateDimension();
+            if (size != checkedSquare(dim)) {
+                throw std::invalid_argument("Buffer has " + std::to_string(size) + " entries, but the matrix has " +
+                                            std::to_string(checkedSquare(dim)) + ".");
+            }
+
+            // split tiles until there are enough for the threads
+            std::vector<MatrixTile> tiles{{edge, {1., 0.}, 0, 0, dim}};
+            while (threads > 1 && tiles.size() < threads) {
+                std::vector<MatrixTile> next{};
+                for (const auto& tile: tiles) {
+                    splitTile(tile, next);
+                }
+                if (next.size() == tiles.size()) {
+                    break;
+                }
+                tiles = std::move(next);
+            }
+
+            if (threads <= 1 || tiles.size() == 1) {
+                for (const auto& tile: tiles) {
+                    extractTile(tile.edge, tile.amplitude, tile.row, tile.col, tile.span, buffer, dim);
+                }
+                return;
+            }
+
+            auto&                          pool = getThreadPool(threads);
+            std::vector<std::future<void>> extractions{};
+            for (const auto& tile: tiles) {
+                extractions.push_back(pool.submit([this, &tile, buffer, dim]() {
+                    extractTile(tile.edge, tile.amplitude, tile.row, tile.col, tile.span, buffer, dim);
+                }));
+            }
+            for (auto& extraction: extractions) {
+                extraction.get();
+            }
+        }
+
+    private:
+        // square block of a matrix starting at (row, col) represented by an edge scaled by amplitude
+        struct MatrixTile {
+            mEdge        edge;
+            ComplexValue amplitude;
+            std::size_t  row;
+            std::size_t  col;
+            std::size_t  span;
+        };
+
+        static std::size_t checkedSquare(std::size_t dim) {
+            if (dim != 0 && dim > std::numeric_limits<std::size_t>::max() / dim) {
+                throw std::overflow_error("The number of matrix entries exceeds the range of std::size_t.");
+            }
+            return dim * dim;
+        }
+
+        // replace a tile by the tiles of its successors, tiles that cannot be split are kept
+        void splitTile(const MatrixTile& tile, std::vector<MatrixTile>& tiles) const {
+            if (tile.edge.isTerminal() || tile.edge.weight.approximatelyZero() || tile.edge.nextNode->identity) {
+                tiles.push_back(tile);
+                return;
+            }
+            const auto  value     = tile.amplitude * valueOf(tile.edge.weight);
+            const auto& edges     = tile.edge.nextNode->edges;
+            const auto  basicDim  = registersSizes.at(static_cast<std::size_t>(tile.edge.nextNode->varIndx));
+            const auto  childSpan = tile.span / basicDim;
+            for (auto i = 0U; i < basicDim; ++i) {
+                for (auto j = 0U; j < basicDim; ++j) {
+                    tiles.push_back({edges.at(i * basicDim + j), value, tile.row + i * childSpan, tile.col + j * childSpan, childSpan});
+                }
+            }
+        }
+
+        // write the block of `edge` with top left corner (row, col) into a row-major buffer with `stride` columns
+        void extractTile(const mEdge& edge, const ComplexValue& amplitude, std::size_t row, std::size_t col, std::size_t span,
+                         std::complex<fp>* buffer, std::size_t stride) const {
+            if (edge.weight.approximatelyZero()) {
+                for (auto r = row; r < row + span; ++r) {
+                    std::fill(buffer + r * stride + col, buffer + r * stride + col + span, std::complex<fp>{0., 0.});
+                }
+                return;
+            }
+
+            const auto value = amplitude * valueOf(edge.weight);
+            if (edge.isTerminal()) {
+                assert(span == 1);
+                buffer[row * stride + col] = {value.r, value.i};
+                return;
+            }
+            if (edge.nextNode->identity) {
+                for (auto r = row; r < row + span; ++r) {
+                    std::fill(buffer + r * stride + col, buffer + r * stride + col + span, std::complex<fp>{0., 0.});
+                    buffer[r * stride + col + (r - row)] = {value.r, value.i};
+                }
+                return;
+            }
+
+            const auto basicDim  = registersSizes.at(static_cast<std::size_t>(edge.nextNode->varIndx));
+            const auto childSpan = span / basicDim;
+            for (auto i = 0U; i < basicDim; ++i) {
+                for (auto j = 0U; j < basicDim; ++j) {
+                    extractTile(edge.nextNode->edges.at(i * basicDim + j), value, row + i * childSpan, col + j * childSpan, childSpan, buffer, stride);
+                }
+            }
+        }
+
+    private:
+        // write the amplitudes of the subtree of `edge`, which covers the indices [offset, offset + span), that lie in
+        // [first, last). `buffer` points to the amplitude with index first.
+        void extractAmplitudes(const vEdge& edge, const ComplexValue& amplitude, std::size_t offset, std::size_t span,
+                               std::size_t first, std::size_t last, std::complex<fp>* buffer) const {
+            const auto begin = std::max(offset, first);
+            const auto end   = std::min(offset + span, last);
+            if (begin >= end) {
+                return;
+            }
+            if (edge.weight.approximatelyZero()) {
+                std::fill(buffer + (begin - first), buffer + (end - first), std::complex<fp>{0., 0.});
+                return;
+            }
+
+            const auto value = amplitude * valueOf(edge.weight);
+            if (edge.isTerminal()) {
+                assert(span == 1);
+                buffer[begin - first] = {value.r, value.i};
+                return;
+            }
+
+            // only the successors overlapping the range are visited
+            const auto childSpan = span / edge.nextNode->edges.size();
+            const auto lastChild = (end - 1 - offset) / childSpan;
+            if (childSpan == 1) {
+                // the successors are terminals, write them without descending
+                for (auto k = begin - offset; k <= lastChild; ++k) {
+                    const auto& weight         = edge.nextNode->edges.at(k).weight;
+                    const auto  entry          = weight.approximatelyZero() ? ComplexValue{0., 0.} : value * valueOf(weight);
+                    buffer[offset + k - first] = {entry.r, entry.i};
+                }
+                return;
+            }
+            for (auto k = (begin - offset) / childSpan; k <= lastChild; ++k) {
+                extractAmplitudes(edge.nextNode->edges.at(k), value, offset + k * childSpan, childSpan, first, last, buffer);
+            }
+        }
+
+        using AmplitudeRequest = std::vector<std::pair<std::size_t, std::size_t>>::const_iterator;
+
+        // amplitudes of the sorted requests in [first, last), which all lie in the subtree of `edge` covering
+        // [offset, offset + span)
+        void collectAmplitudes(const vEdge& edge, const ComplexValue& amplitude, std::size_t offset, std::size_t span,
+                               AmplitudeRequest first, AmplitudeRequest last, std::vector<ComplexValue>& amplitudes) const {
+            if (edge.weight.approximatelyZero()) {
+                return;
+            }
+
+            auto value = amplitude * valueOf(edge.weight);
+            if (edge.isTerminal()) {
+                for (; first != last; ++first) {
+                    amplitudes[first->second] = value;
+                }
+                return;
+            }
+
+            // a single request follows its path without branching
+            if (std::next(first) == last) {
+                auto current = edge;
+                auto local   = first->first - offset;
+                while (!current.isTerminal()) {
+                    span /= current.nextNode->edges.size();
+                    current = current.nextNode->edges[local / span];
+                    local %= span;
+                    if (current.weight.approximatelyZero()) {
+                        return;
+                    }
+                    value = value * valueOf(current.weight);
+                }
+                amplitudes[first->second] = value;
+                return;
+            }
+
+            // the requests of every successor form a contiguous group
+            const auto childSpan = span / edge.nextNode->edges.size();
+            while (first != last) {
+                const auto k         = (first->first - offset) / childSpan;
+                const auto childEnd  = offset + (k + 1) * childSpan;
+                auto       groupLast = std::next(first);
+                while (groupLast != last && groupLast->first < childEnd) {
+                    ++groupLast;
+                }
+                collectAmplitudes(edge.nextNode->edges[k], value, offset + k * childSpan, childSpan, first, groupLast, amplitudes);
+                first = groupLast;
+            }
+        }
+
+    public:
         std::vector<std::size_t> getReprOfIndex(const std::size_t i, const std::size_t numEntries) {
             std::vector<std::size_t> repr;
             repr.reserve(numberOfQuantumRegisters);
@@ -1636,33 +4252,163 @@ namespace dd {
             return repr;
         }
 
-        void printVector(const vEdge& edge, bool nonZero = false) {
-            //unsigned long long numEntries = static_cast<unsigned long long int>(std::accumulate(registersSizes.begin(), registersSizes.end(), 1,std::multiplies<>()));
+        // iterates the nonzero amplitudes of a vector DD in ascending index order by a depth-first traversal.
+        // Storage is allocated once per iterator, advancing it does not allocate.
+        class NonZeroIterator {
+        public:
+            struct Entry {
+                std::size_t              index{};     // register 0 is the least significant digit, only meaningful if
+                                                      // stateDimension() does not overflow
+                ComplexValue             amplitude{};
+                std::vector<std::size_t> digits{};    // level of every register
+            };
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = Entry;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const Entry*;
+            using reference         = const Entry&;
+
+            // past-the-end iterator
+            NonZeroIterator() = default;
+
+            NonZeroIterator(const vEdge& root, const std::vector<std::size_t>& registersSizes) {
+                if (root.nextNode == nullptr || root.weight.approximatelyZero()) {
+                    return;
+                }
+                if (root.isTerminal()) {
+                    entry.amplitude = valueOf(root.weight);
+                    atTerminalRoot  = true;
+                    done            = false;
+                    return;
+                }
 
-            std::size_t numEntries = 1ULL;
-            for (const auto registersSize: registersSizes) {
-                numEntries = numEntries * registersSize;
+                const auto levels = static_cast<std::size_t>(root.nextNode->varIndx) + 1U;
+                strides.assign(levels, 1U);
+                for (auto level = 1U; level < levels; ++level) {
+                    strides.at(level) = strides.at(level - 1) * registersSizes.at(level - 1);
+                }
+                entry.digits.assign(levels, 0U);
+                frames.reserve(levels);
+                frames.push_back({root.nextNode, 0U, 0U, valueOf(root.weight)});
+                done = false;
+                findNext();
+            }
+
+            reference operator*() const { return entry; }
+            pointer   operator->() const { return &entry; }
+
+            NonZeroIterator& operator++() {
+                if (atTerminalRoot) {
+                    done = true;
+                } else {
+                    findNext();
+                }
+                return *this;
+            }
+
+            NonZeroIterator operator++(int) {
+                auto previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+            bool operator==(const NonZeroIterator& other) const {
+                return done == other.done && (done || entry.digits == other.entry.digits);
             }
+            bool operator!=(const NonZeroIterator& other) const { return !(*this == other); }
+
+        private:
+            struct Frame {
+                vNode*       node;
+                std::size_t  position; // position in the nonzero successors of node to visit next
+                std::size_t  offset;   // index of the first amplitude below node
+                ComplexValue amplitude;
+            };
+
+            Entry                    entry{};
+            std::vector<Frame>       frames{};
+            std::vector<std::size_t> strides{};
+            bool                     done           = true;
+            bool                     atTerminalRoot = false;
+
+            void findNext() {
+                while (!frames.empty()) {
+                    auto& frame = frames.back();
+                    if (frame.position == frame.node->nonZeroEdges.size()) {
+                        frames.pop_back();
+                        continue;
+                    }
 
-            for (auto i = 0ULL; i < numEntries; i++) {
-                auto reprI = getReprOfIndex(i, numEntries);
-                // get amplitude
-                const auto amplitude = getValueByPath(edge, reprI);
+                    const auto  k     = frame.node->nonZeroEdges.at(frame.position++);
+                    const auto& edge  = frame.node->edges.at(k);
+                    const auto  level = static_cast<std::size_t>(frame.node->varIndx);
+                    if (edge.weight.approximatelyZero()) {
+                        continue;
+                    }
 
-                if (!amplitude.approximatelyZero() || !nonZero) {
-                    for (const auto coeff: reprI) {
-                        std::cout << coeff;
+                    entry.digits.at(level) = k;
+                    const auto offset      = frame.offset + k * strides.at(level);
+                    const auto amplitude   = frame.amplitude * valueOf(edge.weight);
+                    if (edge.isTerminal()) {
+                        entry.index     = offset;
+                        entry.amplitude = amplitude;
+                        return;
                     }
-                    reprI.clear();
+                    frames.push_back({edge.nextNode, 0U, offset, amplitude});
+                }
+                done = true;
+            }
+        };
+
+        struct NonZeroAmplitudes {
+            vEdge                           edge;
+            const std::vector<std::size_t>& registersSizes;
+
+            [[nodiscard]] NonZeroIterator begin() const { return {edge, registersSizes}; }
+            [[nodiscard]] NonZeroIterator end() const { return {}; }
+        };
 
-                    constexpr auto precision = 3;
-                    // set fixed width to maximum of a printed number
-                    // (-) 0.precision plus/minus 0.precision i
-                    constexpr auto width = 1 + 2 + precision + 1 + 2 + precision + 1;
-                    std::cout << ": " << std::setw(width)
-                              << ComplexValue::toString(amplitude.r, amplitude.i, false,
-                                                        precision)
-                              << "\n";
+        // range of the nonzero amplitudes of a state, e.g., for (const auto& entry: nonZeroAmplitudes(state))
+        [[nodiscard]] NonZeroAmplitudes nonZeroAmplitudes(const vEdge& edge) const {
+            return {edge, registersSizes};
+        }
+
+        void printVector(const vEdge& edge, bool nonZero = false) {
+            constexpr auto precision = 3;
+            // set fixed width to maximum of a printed number
+            // (-) 0.precision plus/minus 0.precision i
+            constexpr auto width = 1 + 2 + precision + 1 + 2 + precision + 1;
+            const auto     print = [](const std::vector<std::size_t>& digits, const ComplexValue& amplitude) {
+                // most significant register first
+                for (auto reg = digits.size(); reg-- > 0;) {
+                    std::cout << digits.at(reg);
+                }
+                std::cout << ": " << std::setw(width)
+                          << ComplexValue::toString(amplitude.r, amplitude.i, false, precision)
+                          << "\n";
+            };
+
+            if (nonZero) {
+                for (const auto& entry: nonZeroAmplitudes(edge)) {
+                    print(entry.digits, entry.amplitude);
+                }
+            } else {
+                // count through all indices in mixed radix and fill in the nonzero amplitudes
+                const auto               amplitudes = nonZeroAmplitudes(edge);
+                auto                     it         = amplitudes.begin();
+                std::vector<std::size_t> digits(numberOfQuantumRegisters, 0U);
+                const auto               dim = stateDimension();
+                for (std::size_t index = 0; index < dim; ++index) {
+                    if (it != amplitudes.end() && it->index == index) {
+                        print(digits, it->amplitude);
+                        ++it;
+                    } else {
+                        print(digits, {0., 0.});
+                    }
+                    for (auto reg = 0U; reg < digits.size() && ++digits.at(reg) == registersSizes.at(reg); ++reg) {
+                        digits.at(reg) = 0;
+                    }
                 }
             }
             std::cout << std::flush;
@@ -1682,65 +4428,69 @@ namespace dd {
         }
 
     private:
-        // check whether node represents a symmetric matrix or the identity
+        // derive whether node represents a symmetric matrix or the identity from the flags of its successors.
+        // Only pointers and weights are compared, no DD is built: the transpose of a successor that is not
+        // symmetric is only known if it has been computed before, otherwise node is treated as not symmetric.
         void checkSpecialMatrices(mNode* node) {
             if (node->varIndx == -1) {
                 return;
             }
 
             node->identity  = false; // assume not identity
-            node->symmetric = false; // assume symmetric
+            node->symmetric = false; // assume not symmetric
 
-            // check if matrix is symmetric
             auto basicDim = registersSizes.at(static_cast<std::size_t>(node->varIndx));
 
+            // check if matrix is the identity on this level tensored with its diagonal successor
+            node->blockIdentity = true;
+            for (auto i = 0UL; i < basicDim && node->blockIdentity; i++) {
+                for (auto j = 0UL; j < basicDim; j++) {
+                    const auto& successor = node->edges.at(i * basicDim + j);
+                    if ((i == j && successor != node->edges.front()) || (i != j && successor.weight != Complex::zero)) {
+                        node->blockIdentity = false;
+                        break;
+                    }
+                }
+            }
+
+            // check if matrix resembles identity, i.e., identities with weight one on the diagonal
+            const auto& diagonal = node->edges.front();
+            if (node->blockIdentity && diagonal.weight == Complex::one && diagonal.nextNode->identity) {
+                node->identity  = true;
+                node->symmetric = true;
+                return;
+            }
+
+            // check if matrix is symmetric
             for (auto i = 0UL; i < basicDim; i++) {
                 if (!node->edges.at(i * basicDim + i).nextNode->symmetric) {
                     return;
                 }
             }
-            // TODO WHY RETURN IF DIAGONAL IS SYMMETRIC??
-            // if (!node->edges.at(0).nextNode->symmetric ||
-            // !node->edges.at(3).nextNode->symmetric) return;
-
             for (auto i = 0UL; i < basicDim; i++) {
-                for (auto j = 0UL; j < basicDim; j++) {
-                    if (i != j) {
-                        // row major indexing - enable optimization here
-                        if (transpose(node->edges.at(i * basicDim + j)) !=
-                            node->edges.at(j * basicDim + i)) {
-                            return;
-                        }
+                for (auto j = i + 1; j < basicDim; j++) {
+                    // row major indexing
+                    const auto& upper = node->edges.at(i * basicDim + j);
+                    const auto& lower = node->edges.at(j * basicDim + i);
+                    if (!isKnownTranspose(upper, lower) && !isKnownTranspose(lower, upper)) {
+                        return;
                     }
                 }
             }
-            // if (transpose(node->edges.at(1)) != node->edges.at(2)) return;
-
             node->symmetric = true;
+        }
 
-            // check if matrix resembles identity
-            for (auto i = 0UL; i < basicDim; i++) {
-                for (auto j = 0UL; j < basicDim; j++) {
-                    // row major indexing - enable optimization here
-                    if (i == j) {
-                        if (!(node->edges[i * basicDim + j].nextNode->identity) ||
-                            (node->edges[i * basicDim + j].weight) != Complex::one) {
-                            return;
-                        }
-                    } else {
-                        if ((node->edges[i * basicDim + j].weight) != Complex::zero) {
-                            return;
-                        }
-                    }
-                }
+        // whether other is the transpose of edge as far as it can be decided without building a DD
+        bool isKnownTranspose(const mEdge& edge, const mEdge& other) {
+            if (edge.weight == Complex::zero || other.weight == Complex::zero) {
+                return edge.weight == other.weight;
             }
-            /*
-          if (!(p->e[0].p->ident) || (p->e[1].w) != Complex::zero ||
-              (p->e[2].w) != Complex::zero || (p->e[0].w) != Complex::one ||
-              (p->e[3].w) != Complex::one || !(p->e[3].p->ident))
-              return;
-          */
-            node->identity = true;
+            if (edge.nextNode->symmetric) {
+                return edge == other;
+            }
+            const auto known = matrixTranspose.lookup({edge.nextNode, Complex::one});
+            return known.nextNode == other.nextNode &&
+                   (valueOf(known.weight) * valueOf(edge.weight)).approximatelyEquals(valueOf(other.weight));
         }
 
         ///
@@ -1757,31 +4507,41 @@ namespace dd {
                 return edge;
             }
 
-            // check in compute table
-            auto result = matrixTranspose.lookup(edge);
-            if (result.nextNode != nullptr) {
-                return result;
-            }
-
-            std::vector<mEdge> newEdge{};
-            auto               basicDim = registersSizes.at(static_cast<std::size_t>(edge.nextNode->varIndx));
-
-            // transpose sub-matrices and rearrange as required
-            for (auto i = 0U; i < basicDim; i++) {
-                for (auto j = 0U; j < basicDim; j++) {
-                    newEdge.at(basicDim * i + j) =
-                            transpose(edge.nextNode->edges.at(basicDim * j + i));
+            // the compute table holds the transposes of nodes, i.e., of edges with weight one
+            const mEdge node{edge.nextNode, Complex::one};
+            auto        result = matrixTranspose.lookup(node);
+            if (result.nextNode == nullptr) {
+                auto               basicDim = registersSizes.at(static_cast<std::size_t>(edge.nextNode->varIndx));
+                std::vector<mEdge> newEdge(basicDim * basicDim, mEdge::zero);
+
+                if (edge.nextNode->blockIdentity) {
+                    // only the diagonal successor has to be transposed
+                    const auto diagonal = transpose(edge.nextNode->edges.front());
+                    for (auto i = 0U; i < basicDim; i++) {
+                        newEdge.at(basicDim * i + i) = diagonal;
+                    }
+                } else {
+                    // transpose sub-matrices and rearrange as required
+                    for (auto i = 0U; i < basicDim; i++) {
+                        for (auto j = 0U; j < basicDim; j++) {
+                            newEdge.at(basicDim * i + j) =
+                                    transpose(edge.nextNode->edges.at(basicDim * j + i));
+                        }
+                    }
                 }
+                // create new top node
+                result = makeDDNode(edge.nextNode->varIndx, newEdge);
+
+                // put in compute table
+                matrixTranspose.insert(node, result);
             }
-            // create new top node
-            result = makeDDNode(edge.nextNode->varIndx, newEdge);
-            // adjust top weight
-            auto c = complexNumber.getTemporary();
-            ComplexNumbers::mul(c, result.weight, edge.weight);
-            result.weight = complexNumber.lookup(c);
 
-            // put in compute table
-            matrixTranspose.insert(edge, result);
+            // adjust top weight
+            if (edge.weight != Complex::one) {
+                auto c = complexNumber.getTemporary();
+                ComplexNumbers::mul(c, result.weight, edge.weight);
+                result.weight = complexNumber.lookup(c);
+            }
             return result;
         }
         mEdge conjugateTranspose(const mEdge& edge) {
@@ -1803,10 +4563,18 @@ namespace dd {
             std::vector<mEdge> newEdge(edge.nextNode->edges.size(), dd::Edge<mNode>::zero);
             auto               basicDim = registersSizes.at(static_cast<std::size_t>(edge.nextNode->varIndx));
 
-            // conjugate transpose submatrices and rearrange as required
-            for (auto i = 0U; i < basicDim; ++i) {
-                for (auto j = 0U; j < basicDim; ++j) {
-                    newEdge.at(basicDim * i + j) = conjugateTranspose(edge.nextNode->edges.at(basicDim * j + i));
+            if (edge.nextNode->blockIdentity) {
+                // only the diagonal successor has to be conjugate transposed
+                const auto diagonal = conjugateTranspose(edge.nextNode->edges.front());
+                for (auto i = 0U; i < basicDim; ++i) {
+                    newEdge.at(basicDim * i + i) = diagonal;
+                }
+            } else {
+                // conjugate transpose submatrices and rearrange as required
+                for (auto i = 0U; i < basicDim; ++i) {
+                    for (auto j = 0U; j < basicDim; ++j) {
+                        newEdge.at(basicDim * i + j) = conjugateTranspose(edge.nextNode->edges.at(basicDim * j + i));
+                    }
                 }
             }
             // create new top node
@@ -1829,20 +4597,25 @@ namespace dd {
     public:
         // unique tables
         template<class Node>
-        [[nodiscard]] UniqueTable<Node>& getUniqueTable();
+        [[nodiscard]] ConcurrentUniqueTable<Node>& getUniqueTable();
 
+        // nodes are never collected, so references need not be counted. Kept for callers of the former API.
         template<class Node>
-        void incRef(const Edge<Node>& e) {
-            getUniqueTable<Node>().incRef(e);
-        }
+        void incRef([[maybe_unused]] const Edge<Node>& e) {}
 
         template<class Node>
-        void decRef(const Edge<Node>& e) {
-            getUniqueTable<Node>().decRef(e);
-        }
+        void decRef([[maybe_unused]] const Edge<Node>& e) {}
+
+    private:
+        // shared with the packages of other threads created from this one
+        std::shared_ptr<ConcurrentUniqueTable<vNode>> vUniqueTableStorage{std::make_shared<ConcurrentUniqueTable<vNode>>(numberOfQuantumRegisters)};
+        std::shared_ptr<ConcurrentUniqueTable<mNode>> mUniqueTableStorage{std::make_shared<ConcurrentUniqueTable<mNode>>(numberOfQuantumRegisters)};
+        std::shared_ptr<ConcurrentUniqueTable<dNode>> dUniqueTableStorage{std::make_shared<ConcurrentUniqueTable<dNode>>(numberOfQuantumRegisters)};
 
-        UniqueTable<vNode> vUniqueTable{numberOfQuantumRegisters};
-        UniqueTable<mNode> mUniqueTable{numberOfQuantumRegisters};
+    public:
+        ConcurrentUniqueTable<vNode>& vUniqueTable{*vUniqueTableStorage};
+        ConcurrentUniqueTable<mNode>& mUniqueTable{*mUniqueTableStorage};
+        ConcurrentUniqueTable<dNode>& dUniqueTable{*dUniqueTableStorage};
     };
 
     inline void clearUniqueTables() {
@@ -1866,18 +4639,34 @@ namespace dd {
             true,
             true};
 
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    inline MDDPackage::dNode MDDPackage::dNode::terminalNode{
+            {{{nullptr, Complex::zero},
+              {nullptr, Complex::zero},
+              {nullptr, Complex::zero},
+              {nullptr, Complex::zero}}},
+            nullptr,
+            0,
+            -1};
+
     template<>
-    [[nodiscard]] inline UniqueTable<MDDPackage::vNode>&
+    [[nodiscard]] inline ConcurrentUniqueTable<MDDPackage::vNode>&
     MDDPackage::getUniqueTable() {
         return vUniqueTable;
     }
 
     template<>
-    [[nodiscard]] inline UniqueTable<MDDPackage::mNode>&
+    [[nodiscard]] inline ConcurrentUniqueTable<MDDPackage::mNode>&
     MDDPackage::getUniqueTable() {
         return mUniqueTable;
     }
 
+    template<>
+    [[nodiscard]] inline ConcurrentUniqueTable<MDDPackage::dNode>&
+    MDDPackage::getUniqueTable() {
+        return dUniqueTable;
+    }
+
     template<>
     [[nodiscard]] inline ComputeTable<MDDPackage::vCachedEdge,
                                       MDDPackage::vCachedEdge,
@@ -1894,6 +4683,14 @@ namespace dd {
         return matrixAdd;
     }
 
+    template<>
+    [[nodiscard]] inline ComputeTable<MDDPackage::dCachedEdge,
+                                      MDDPackage::dCachedEdge,
+                                      MDDPackage::dCachedEdge>&
+    MDDPackage::getAddComputeTable() {
+        return *densityAdd;
+    }
+
     template<>
     [[nodiscard]] inline ComputeTable<MDDPackage::mEdge, MDDPackage::vEdge,
                                       MDDPackage::vCachedEdge>&
@@ -1908,6 +4705,20 @@ namespace dd {
         return matrixMatrixMultiplication;
     }
 
+    template<>
+    [[nodiscard]] inline ComputeTable<MDDPackage::mEdge, MDDPackage::vEdge,
+                                      MDDPackage::vCachedEdge>&
+    MDDPackage::getAdjointMultiplicationComputeTable() {
+        return *matrixVectorAdjointMultiplication;
+    }
+
+    template<>
+    [[nodiscard]] inline ComputeTable<MDDPackage::mEdge, MDDPackage::mEdge,
+                                      MDDPackage::mCachedEdge>&
+    MDDPackage::getAdjointMultiplicationComputeTable() {
+        return *matrixMatrixAdjointMultiplication;
+    }
+
     template<>
     [[nodiscard]] inline ComputeTable<MDDPackage::vEdge, MDDPackage::vEdge,
                                       MDDPackage::vCachedEdge, 4096>&
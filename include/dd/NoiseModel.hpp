@@ -0,0 +1,34 @@
+/*
+ * This file is part of the MQT DD Package which is released under the MIT license.
+ * See file README.md or go to https://www.cda.cit.tum.de/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_NOISEMODEL_HPP
+#define DD_PACKAGE_NOISEMODEL_HPP
+
+#include "Definitions.hpp"
+
+#include <stdexcept>
+
+namespace dd {
+    // stochastic noise applied to every register an operation acts on, right after the operation
+    struct NoiseModel {
+        fp depolarization   = 0.; // probability of a uniformly random non-identity generalized Pauli error X^a Z^b
+        fp dephasing        = 0.; // probability of a uniformly random non-identity phase error Z^b
+        fp amplitudeDamping = 0.; // probability of every excited level k to decay to k - 1
+
+        [[nodiscard]] bool isNoiseless() const {
+            return depolarization == 0. && dephasing == 0. && amplitudeDamping == 0.;
+        }
+
+        void validate() const {
+            for (const auto p: {depolarization, dephasing, amplitudeDamping}) {
+                if (p < 0. || p > 1.) {
+                    throw std::invalid_argument("Noise probabilities have to lie in [0, 1].");
+                }
+            }
+        }
+    };
+} // namespace dd
+
+#endif //DD_PACKAGE_NOISEMODEL_HPP
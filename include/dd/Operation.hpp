@@ -0,0 +1,93 @@
+/*
+ * This file is part of the MQT DD Package which is released under the MIT license.
+ * See file README.md or go to https://www.cda.cit.tum.de/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_OPERATION_HPP
+#define DD_PACKAGE_OPERATION_HPP
+
+#include "ComplexValue.hpp"
+#include "Control.hpp"
+#include "Definitions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace dd {
+    // a (controlled) gate given by its dense matrix in row-major order.
+    // For two targets the matrix acts on the joint space with targets[0] as the more significant index.
+    struct Operation {
+        std::vector<ComplexValue>    matrix{};
+        std::vector<QuantumRegister> targets{};
+        Controls                     controls{};
+
+        [[nodiscard]] bool actsOn(QuantumRegister reg) const {
+            return std::find(targets.begin(), targets.end(), reg) != targets.end() || controls.count(reg) > 0;
+        }
+
+        [[nodiscard]] bool overlaps(const Operation& other) const {
+            return std::any_of(targets.begin(), targets.end(), [&other](QuantumRegister reg) { return other.actsOn(reg); }) ||
+                   std::any_of(controls.begin(), controls.end(), [&other](const Control& c) { return other.actsOn(c.quantumRegister); });
+        }
+    };
+
+    // dense product second * first of two square matrices, i.e., first is applied before second
+    inline std::vector<ComplexValue> multiplyDense(const std::vector<ComplexValue>& second, const std::vector<ComplexValue>& first) {
+        if (second.size() != first.size()) {
+            throw std::invalid_argument("Cannot multiply matrices of different sizes.");
+        }
+        const auto dim = static_cast<std::size_t>(std::lround(std::sqrt(static_cast<fp>(first.size()))));
+
+        std::vector<ComplexValue> product(first.size(), ComplexValue{0., 0.});
+        for (auto row = 0U; row < dim; ++row) {
+            for (auto k = 0U; k < dim; ++k) {
+                const auto& factor = second.at(row * dim + k);
+                if (factor.r == 0 && factor.i == 0) {
+                    continue;
+                }
+                for (auto col = 0U; col < dim; ++col) {
+                    product.at(row * dim + col) += factor * first.at(k * dim + col);
+                }
+            }
+        }
+        return product;
+    }
+
+    // merge consecutive operations with identical targets and controls into a single operation.
+    // Operations in between that act on disjoint registers commute with a run and do not break it.
+    // The result implements the same unitary as the input sequence.
+    inline std::vector<Operation> fuseOperations(const std::vector<Operation>& operations) {
+        std::vector<Operation> fused{};
+        fused.reserve(operations.size());
+
+        // operations not yet emitted, all of them act on pairwise disjoint registers
+        std::vector<Operation> pending{};
+
+        for (const auto& op: operations) {
+            auto partner = std::find_if(pending.begin(), pending.end(), [&op](const Operation& p) {
+                return p.targets == op.targets && p.controls == op.controls;
+            });
+            if (partner != pending.end()) {
+                partner->matrix = multiplyDense(op.matrix, partner->matrix);
+                continue;
+            }
+
+            // everything sharing a register with the new operation has to be applied before it
+            auto blocked = std::stable_partition(pending.begin(), pending.end(), [&op](const Operation& p) {
+                return !p.overlaps(op);
+            });
+            std::move(blocked, pending.end(), std::back_inserter(fused));
+            pending.erase(blocked, pending.end());
+
+            pending.push_back(op);
+        }
+        std::move(pending.begin(), pending.end(), std::back_inserter(fused));
+        return fused;
+    }
+} // namespace dd
+
+#endif //DD_PACKAGE_OPERATION_HPP
@@ -0,0 +1,59 @@
+/*
+ * This file is part of the MQT DD Package which is released under the MIT license.
+ * See file README.md or go to https://www.cda.cit.tum.de/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_SPARSEMATRIX_HPP
+#define DD_PACKAGE_SPARSEMATRIX_HPP
+
+#include "Definitions.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace dd {
+    // square sparse matrix in compressed sparse row format, i.e., the entries of row r are stored at the
+    // positions [rowPointers[r], rowPointers[r + 1]) of columnIndices and values
+    struct CSRMatrix {
+        std::size_t                   dimension = 0;
+        std::vector<std::size_t>      rowPointers{};
+        std::vector<std::size_t>      columnIndices{};
+        std::vector<std::complex<fp>> values{};
+
+        void validate() const {
+            if (rowPointers.size() != dimension + 1 || rowPointers.front() != 0 || rowPointers.back() != values.size() ||
+                columnIndices.size() != values.size()) {
+                throw std::invalid_argument("Row pointers of the CSR matrix do not match its dimension and entries.");
+            }
+            if (!std::is_sorted(rowPointers.begin(), rowPointers.end())) {
+                throw std::invalid_argument("Row pointers of the CSR matrix have to be non-decreasing.");
+            }
+            if (std::any_of(columnIndices.begin(), columnIndices.end(), [this](std::size_t col) { return col >= dimension; })) {
+                throw std::invalid_argument("Column index of the CSR matrix out of range.");
+            }
+        }
+    };
+
+    // square sparse matrix in coordinate format. Entries may be given in any order, duplicates are summed up.
+    struct COOMatrix {
+        std::size_t                   dimension = 0;
+        std::vector<std::size_t>      rows{};
+        std::vector<std::size_t>      columns{};
+        std::vector<std::complex<fp>> values{};
+
+        void validate() const {
+            if (rows.size() != values.size() || columns.size() != values.size()) {
+                throw std::invalid_argument("Rows, columns, and values of the COO matrix differ in length.");
+            }
+            const auto outOfRange = [this](std::size_t index) { return index >= dimension; };
+            if (std::any_of(rows.begin(), rows.end(), outOfRange) || std::any_of(columns.begin(), columns.end(), outOfRange)) {
+                throw std::invalid_argument("Index of the COO matrix out of range.");
+            }
+        }
+    };
+} // namespace dd
+
+#endif //DD_PACKAGE_SPARSEMATRIX_HPP
@@ -0,0 +1,104 @@
+/*
+ * This file is part of the MQT DD Package which is released under the MIT license.
+ * See file README.md or go to https://www.cda.cit.tum.de/research/quantum_dd/ for more information.
+ */
+
+#ifndef DDpackage_TERNARYCOMPUTETABLE_HPP
+#define DDpackage_TERNARYCOMPUTETABLE_HPP
+
+#include "Definitions.hpp"
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+
+namespace dd {
+
+    /// Data structure for caching computed results of ternary operations
+    /// \tparam FirstOperandType type of the operation's first operand
+    /// \tparam SecondOperandType type of the operation's second operand
+    /// \tparam ThirdOperandType type of the operation's third operand
+    /// \tparam ResultType type of the operation's result
+    /// \tparam NBUCKET number of hash buckets to use (has to be a power of two)
+    template<class FirstOperandType, class SecondOperandType, class ThirdOperandType, class ResultType, std::size_t NBUCKET = 16384>
+    class TernaryComputeTable {
+    public:
+        TernaryComputeTable() = default;
+
+        struct Entry {
+            FirstOperandType  firstOperand;
+            SecondOperandType secondOperand;
+            ThirdOperandType  thirdOperand;
+            ResultType        result;
+        };
+
+        static constexpr std::size_t MASK = NBUCKET - 1;
+
+        static std::size_t hash(const FirstOperandType& firstOperand, const SecondOperandType& secondOperand,
+                                const ThirdOperandType& thirdOperand) {
+            const auto h1   = std::hash<FirstOperandType>{}(firstOperand);
+            const auto h2   = std::hash<SecondOperandType>{}(secondOperand);
+            const auto h3   = std::hash<ThirdOperandType>{}(thirdOperand);
+            const auto hash = dd::combineHash(dd::combineHash(h1, h2), h3);
+            return hash & MASK;
+        }
+
+        // access functions
+        [[nodiscard]] const auto& getTable() const { return table; }
+
+        void insert(const FirstOperandType& firstOperand, const SecondOperandType& secondOperand,
+                    const ThirdOperandType& thirdOperand, const ResultType& result) {
+            const auto key = hash(firstOperand, secondOperand, thirdOperand);
+            table[key]     = {firstOperand, secondOperand, thirdOperand, result};
+            ++count;
+        }
+
+        ResultType lookup(const FirstOperandType& firstOperand, const SecondOperandType& secondOperand,
+                          const ThirdOperandType& thirdOperand) {
+            ResultType result{};
+            lookups++;
+            const auto key   = hash(firstOperand, secondOperand, thirdOperand);
+            auto&      entry = table[key];
+            if (entry.result.nextNode == nullptr) {
+                return result;
+            }
+            if (entry.firstOperand != firstOperand || entry.secondOperand != secondOperand ||
+                entry.thirdOperand != thirdOperand) {
+                return result;
+            }
+
+            hits++;
+            return entry.result;
+        }
+
+        void clear() {
+            if (count > 0) {
+                for (auto& entry: table) {
+                    entry.result.nextNode = nullptr;
+                }
+                count = 0;
+            }
+            hits    = 0;
+            lookups = 0;
+        }
+
+        [[nodiscard]] std::size_t getHits() const { return hits; }
+        [[nodiscard]] std::size_t getLookups() const { return lookups; }
+
+        [[nodiscard]] fp hitRatio() const { return static_cast<fp>(hits) / lookups; }
+        std::ostream&    printStatistics(std::ostream& os = std::cout) {
+            os << "hits: " << hits << ", looks: " << lookups << ", ratio: " << hitRatio() << std::endl;
+            return os;
+        }
+
+    private:
+        std::array<Entry, NBUCKET> table{};
+        // compute table lookup statistics
+        std::size_t hits    = 0;
+        std::size_t lookups = 0;
+        std::size_t count   = 0;
+    };
+} // namespace dd
+
+#endif //DDpackage_TERNARYCOMPUTETABLE_HPP
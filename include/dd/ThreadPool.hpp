@@ -0,0 +1,157 @@
+/*
+ * This file is part of the MQT DD Package which is released under the MIT license.
+ * See file README.md or go to https://www.cda.cit.tum.de/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_THREADPOOL_HPP
+#define DD_PACKAGE_THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dd {
+    // work-stealing thread pool. Every worker owns a deque of tasks: it pops its own tasks from the back,
+    // idle workers steal from the front of the other deques. Tasks submitted by a worker are pushed to its
+    // own deque, tasks submitted from outside are distributed round-robin.
+    class ThreadPool {
+    public:
+        static constexpr std::size_t NO_WORKER = std::numeric_limits<std::size_t>::max();
+
+        explicit ThreadPool(std::size_t nthreads = std::thread::hardware_concurrency()) {
+            nthreads = std::max<std::size_t>(nthreads, 1U);
+            queues.reserve(nthreads);
+            for (auto i = 0U; i < nthreads; ++i) {
+                queues.push_back(std::make_unique<TaskQueue>());
+            }
+            workers.reserve(nthreads);
+            for (auto i = 0U; i < nthreads; ++i) {
+                workers.emplace_back([this, i]() { run(i); });
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                const std::lock_guard<std::mutex> lock(wakeMutex);
+                stop = true;
+            }
+            wake.notify_all();
+            for (auto& worker: workers) {
+                worker.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        [[nodiscard]] std::size_t size() const { return workers.size(); }
+
+        // index of the pool worker executing the calling thread or NO_WORKER for threads outside of any pool
+        [[nodiscard]] static std::size_t currentWorker() { return workerIndex(); }
+
+        template<class F>
+        auto submit(F&& f) -> std::future<std::invoke_result_t<F>> {
+            using Result = std::invoke_result_t<F>;
+
+            auto task   = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+            auto result = task->get_future();
+
+            const auto owner  = (workerIndex() != NO_WORKER && workerPool() == this) ? workerIndex() : nextQueue++ % queues.size();
+            auto&      target = *queues.at(owner);
+            {
+                const std::lock_guard<std::mutex> lock(target.mutex);
+                target.tasks.emplace_back([task]() { (*task)(); });
+            }
+            {
+                const std::lock_guard<std::mutex> lock(wakeMutex);
+                ++pending;
+            }
+            wake.notify_one();
+            return result;
+        }
+
+    private:
+        struct TaskQueue {
+            std::mutex                        mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<TaskQueue>> queues{};
+        std::vector<std::thread>                workers{};
+        std::atomic<std::size_t>                nextQueue{0};
+
+        std::mutex              wakeMutex{};
+        std::condition_variable wake{};
+        std::size_t             pending = 0; // number of queued tasks, guarded by wakeMutex
+        bool                    stop    = false;
+
+        static std::size_t& workerIndex() {
+            thread_local std::size_t index = NO_WORKER;
+            return index;
+        }
+
+        static ThreadPool*& workerPool() {
+            thread_local ThreadPool* pool = nullptr;
+            return pool;
+        }
+
+        bool tryPop(std::size_t index, std::function<void()>& task) {
+            // own tasks in LIFO order
+            {
+                auto&                             own = *queues.at(index);
+                const std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            // steal the oldest task of another worker
+            for (auto offset = 1U; offset < queues.size(); ++offset) {
+                auto&                             victim = *queues.at((index + offset) % queues.size());
+                const std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run(std::size_t index) {
+            workerIndex() = index;
+            workerPool()  = this;
+
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(wakeMutex);
+                    wake.wait(lock, [this]() { return stop || pending > 0; });
+                    if (pending == 0) {
+                        return;
+                    }
+                    --pending;
+                }
+                // a task is reserved for this worker, it may only be found in another queue
+                std::function<void()> task{};
+                while (!tryPop(index, task)) {
+                    std::this_thread::yield();
+                }
+                task();
+            }
+        }
+    };
+} // namespace dd
+
+#endif //DD_PACKAGE_THREADPOOL_HPP
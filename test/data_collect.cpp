@@ -4,6 +4,7 @@
 #include <fstream>
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 dd::Edge<dd::MDDPackage::vNode> fullMixWState([[maybe_unused]] std::ofstream& file, std::vector<size_t> orderOfLayers) {
@@ -180,7 +181,7 @@ dd::Edge<dd::MDDPackage::vNode> ghzQutritStateScaled(std::ofstream& file, dd::Qu
     return evolution;
 }
 
-dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::size_t d, std::ofstream& file) {
+dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::size_t d, std::ofstream& file, std::size_t threads = 1) {
     const dd::QuantumRegisterCount width = w;
     const std::size_t              depth = d;
     const std::size_t              maxD  = 5;
@@ -217,23 +218,23 @@ dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::
                 if (localChoice == 0) { //hadamard
                     if (particles.at(line) == 2) {
                         auto chosenGate = dd->makeGateDD<dd::GateMatrix>(dd::H(), width, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 3) {
                         auto chosenGate = dd->makeGateDD<dd::TritMatrix>(dd::H3(), width, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 4) {
                         auto chosenGate = dd->makeGateDD<dd::QuartMatrix>(dd::H4(), width, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 5) {
                         auto chosenGate = dd->makeGateDD<dd::QuintMatrix>(dd::H5(), width, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     }
                 } else { //givens
                     if (particles.at(line) == 2) {
                         const double theta      = 0.;
                         const double phi        = 0.;
                         auto         chosenGate = dd->makeGateDD<dd::GateMatrix>(dd::RXY(theta, phi), width, static_cast<dd::QuantumRegister>(line));
-                        evolution               = dd->multiply(chosenGate, evolution);
+                        evolution               = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 3) {
                         const double                               theta = angles(gen);
                         const double                               phi   = angles(gen);
@@ -248,7 +249,7 @@ dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::
                         }
 
                         auto chosenGate = dd->makeGateDD<dd::TritMatrix>(dd::RXY3(theta, phi, levelA, levelB), width, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 4) {
                         const double                               theta = angles(gen);
                         const double                               phi   = angles(gen);
@@ -263,7 +264,7 @@ dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::
                         }
 
                         auto chosenGate = dd->makeGateDD<dd::QuartMatrix>(dd::RXY4(theta, phi, levelA, levelB), width, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 5) {
                         const double                               theta = angles(gen);
                         const double                               phi   = angles(gen);
@@ -278,7 +279,7 @@ dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::
                         }
 
                         auto chosenGate = dd->makeGateDD<dd::QuintMatrix>(dd::RXY5(theta, phi, levelA, levelB), width, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     }
                 }
             } else { //entangling
@@ -314,7 +315,7 @@ dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::
                         const double theta      = angles(gen);
                         const double phi        = angles(gen);
                         auto         chosenGate = dd->makeGateDD<dd::GateMatrix>(dd::RXY(theta, phi), width, control, static_cast<dd::QuantumRegister>(line));
-                        evolution               = dd->multiply(chosenGate, evolution);
+                        evolution               = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 3) {
                         std::uniform_int_distribution<std::size_t> picklevel(0, 2);
 
@@ -329,7 +330,7 @@ dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::
                         }
 
                         auto chosenGate = dd->makeGateDD<dd::TritMatrix>(dd::RXY3(theta, phi, levelA, levelB), width, control, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 4) {
                         std::uniform_int_distribution<std::size_t> picklevel(0, 3);
 
@@ -344,7 +345,7 @@ dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::
                         }
 
                         auto chosenGate = dd->makeGateDD<dd::QuartMatrix>(dd::RXY4(theta, phi, levelA, levelB), width, control, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 5) {
                         std::uniform_int_distribution<std::size_t> picklevel(0, 4);
 
@@ -359,21 +360,21 @@ dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::
                         }
 
                         auto chosenGate = dd->makeGateDD<dd::QuintMatrix>(dd::RXY5(theta, phi, levelA, levelB), width, control, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     }
                 } else { // Controlled clifford
                     if (particles.at(line) == 2) {
                         auto chosenGate = dd->makeGateDD<dd::GateMatrix>(dd::Xmat, width, control, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 3) {
                         auto chosenGate = dd->makeGateDD<dd::TritMatrix>(dd::X3, width, control, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 4) {
                         auto chosenGate = dd->makeGateDD<dd::QuartMatrix>(dd::X4, width, control, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     } else if (particles.at(line) == 5) {
                         auto chosenGate = dd->makeGateDD<dd::QuintMatrix>(dd::X5, width, control, static_cast<dd::QuantumRegister>(line));
-                        evolution       = dd->multiply(chosenGate, evolution);
+                        evolution       = dd->multiplyParallel(chosenGate, evolution, threads);
                     }
                 }
             }
@@ -397,6 +398,71 @@ dd::Edge<dd::MDDPackage::vNode> randomCircuits(dd::QuantumRegisterCount w, std::
     file << "Random, " << particles.size() << ", " << oss.str() << ", " << numop << ", " << numnodes << ", " << numcplx << ", " << (static_cast<double>(elapsed.count()) * 1e-9) << "\n";
     return evolution;
 }
+// build the unitary of a random circuit with every combination order and compare their cost
+void unitaryOrders(dd::QuantumRegisterCount w, std::size_t d, std::ofstream& file) {
+    const dd::QuantumRegisterCount width = w;
+    const std::size_t              depth = d;
+
+    std::mt19937 gen(1592645427); // seed the generator
+
+    std::vector<std::size_t>                   particles = {};
+    std::uniform_int_distribution<std::size_t> dimdistr(2, 3);
+    particles.reserve(width);
+    for (auto i = 0U; i < width; i++) {
+        particles.push_back(dimdistr(gen));
+    }
+
+    std::uniform_int_distribution<>            pickbool(0, 1);
+    std::uniform_int_distribution<std::size_t> pickcontrols(1, width - 1);
+    std::uniform_real_distribution<>           angles(0.0, 2. * dd::PI);
+
+    auto toVector = [](const auto& mat) { return std::vector<dd::ComplexValue>(mat.begin(), mat.end()); };
+
+    std::vector<dd::Operation> circuit{};
+    for (auto timeStep = 0U; timeStep < depth; timeStep++) {
+        for (auto line = 0U; line < width; line++) {
+            const auto target = static_cast<dd::QuantumRegister>(line);
+            if (pickbool(gen) == 0) { //local op
+                if (particles.at(line) == 2) {
+                    circuit.push_back({toVector(dd::RXY(angles(gen), angles(gen))), {target}, {}});
+                } else {
+                    circuit.push_back({toVector(dd::RXY3(angles(gen), angles(gen), 0, 1)), {target}, {}});
+                }
+            } else { //entangling gate
+                const auto         controlLine = (line + pickcontrols(gen)) % width;
+                const dd::Controls control{{static_cast<dd::QuantumRegister>(controlLine), 1}};
+                if (particles.at(line) == 2) {
+                    circuit.push_back({toVector(dd::Xmat), {target}, control});
+                } else {
+                    circuit.push_back({toVector(dd::X3), {target}, control});
+                }
+            }
+        }
+    }
+
+    std::ostringstream oss;
+    for (const auto particle: particles) {
+        oss << particle;
+    }
+
+    const std::vector<std::pair<std::string, dd::MDDPackage::UnitaryOrder>> orders{
+            {"Sequential", dd::MDDPackage::UnitaryOrder::Sequential},
+            {"Balanced", dd::MDDPackage::UnitaryOrder::Balanced},
+            {"SizeAware", dd::MDDPackage::UnitaryOrder::SizeAware}};
+    for (const auto& [name, order]: orders) {
+        for (const std::size_t threads: {1U, 4U}) {
+            if (threads > 1 && order != dd::MDDPackage::UnitaryOrder::Balanced) {
+                continue;
+            }
+            auto                              dd = std::make_unique<dd::MDDPackage>(width, particles);
+            dd::MDDPackage::UnitaryStatistics statistics{};
+            dd->buildUnitary(circuit, statistics, order, threads);
+
+            file << "Unitary" << name << threads << ", " << particles.size() << ", " << oss.str() << ", " << circuit.size() << ", " << statistics.peakIntermediateNodes << ", " << statistics.uniqueTableNodes << ", " << statistics.seconds << "\n";
+        }
+    }
+}
+
 int main() { // NOLINT(bugprone-exception-escape)
     std::ofstream myfile;
     myfile.open("/home/k3vn/Desktop/trycollect.csv", std::ios_base::app);
@@ -476,6 +542,24 @@ int main() { // NOLINT(bugprone-exception-escape)
     std::cout << "7 set"
               << "\n";
 
+    myfile.close();
+    myfile.open("/home/k3vn/Desktop/trycollect.csv", std::ios_base::app);
+    randomCircuits(12, 1000, myfile, std::thread::hardware_concurrency());
+    randomCircuits(13, 1000, myfile, std::thread::hardware_concurrency());
+
+    std::cout << "parallel set"
+              << "\n";
+
+    myfile.close();
+    myfile.open("/home/k3vn/Desktop/trycollect.csv", std::ios_base::app);
+    myfile << "Bench, NumLines, Qudits, Operations, PeakNodes, CreatedNodes, time\n";
+    unitaryOrders(3, 20, myfile);
+    unitaryOrders(4, 10, myfile);
+    unitaryOrders(5, 10, myfile);
+
+    std::cout << "8 set"
+              << "\n";
+
     myfile.close();
     return 0;
 }
@@ -4,6 +4,33 @@
 
 using namespace dd::literals;
 
+namespace {
+    // non-symmetric, non-unitary operator with complex entries on a sparse pattern
+    dd::COOMatrix makeTestOperator(std::size_t dim) {
+        dd::COOMatrix entries{dim, {}, {}, {}};
+        for (auto row = 0U; row < dim; ++row) {
+            for (auto col = 0U; col < dim; ++col) {
+                if ((row * 7 + col * 3) % 5 == 0) {
+                    entries.rows.push_back(row);
+                    entries.columns.push_back(col);
+                    entries.values.emplace_back(0.1 * (row + 1), 0.05 * col - 0.3);
+                }
+            }
+        }
+        return entries;
+    }
+
+    void expectMatricesNear(const dd::CMat& actual, const dd::CMat& expected, dd::fp tolerance = 1e-12) {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (auto row = 0U; row < expected.size(); ++row) {
+            ASSERT_EQ(actual.at(row).size(), expected.at(row).size());
+            for (auto col = 0U; col < expected.at(row).size(); ++col) {
+                EXPECT_NEAR(std::abs(actual.at(row).at(col) - expected.at(row).at(col)), 0., tolerance) << "entry (" << row << ", " << col << ")";
+            }
+        }
+    }
+} // namespace
+
 TEST(DDPackageTest, RequestInvalidPackageSize) {
     EXPECT_THROW(auto dd = std::make_unique<dd::MDDPackage>(
                          std::numeric_limits<dd::QuantumRegister>::max() + 2,
@@ -941,3 +968,1157 @@ TEST(DDPackageTest, RandomCircuits) {
         }
     }
 }
+
+TEST(DDPackageTest, TwoQuditGate) {
+    auto dd = std::make_unique<dd::MDDPackage>(4, std::vector<std::size_t>{3, 2, 3, 2});
+
+    // controlled X3 on register 2 conditioned on level 1 of register 0, written as dense two-qutrit matrix
+    std::vector<dd::ComplexValue> cx(81, dd::COMPLEX_ZERO);
+    for (auto level = 0U; level < 3U; level++) {
+        for (auto row = 0U; row < 3U; row++) {
+            for (auto col = 0U; col < 3U; col++) {
+                const auto value = (level == 1U) ? dd::X3.at(row * 3 + col) : dd::I3.at(row * 3 + col);
+                cx.at((level * 3 + row) * 9 + level * 3 + col) = value;
+            }
+        }
+    }
+
+    dd::Controls const control01{{0, 1}};
+    auto               controlled = dd->makeGateDD<dd::TritMatrix>(dd::X3, 4, control01, 2);
+    auto               twoQudit   = dd->makeTwoQuditGateDD(cx, 4, 0, 2);
+    EXPECT_EQ(twoQudit, controlled);
+
+    // same operation with the roles of the matrix indices swapped
+    std::vector<dd::ComplexValue> xc(81, dd::COMPLEX_ZERO);
+    for (auto row = 0U; row < 9U; row++) {
+        for (auto col = 0U; col < 9U; col++) {
+            xc.at((row % 3 * 3 + row / 3) * 9 + col % 3 * 3 + col / 3) = cx.at(row * 9 + col);
+        }
+    }
+    EXPECT_EQ(dd->makeTwoQuditGateDD(xc, 4, 2, 0), controlled);
+
+    // additional controls below, between and above the targets
+    dd::Controls const control0113{{0, 1}, {1, 1}, {3, 0}};
+    dd::Controls const control13{{1, 1}, {3, 0}};
+    EXPECT_EQ(dd->makeTwoQuditGateDD(cx, 4, control13, 0, 2),
+              dd->makeGateDD<dd::TritMatrix>(dd::X3, 4, control0113, 2));
+
+    auto evolution = dd->multiply(twoQudit, dd->makeBasisState(4, {1, 0, 0, 0}));
+    EXPECT_NEAR(dd->fidelity(evolution, dd->makeBasisState(4, {1, 0, 1, 0})), 1.0, dd::ComplexTable<>::tolerance());
+
+    EXPECT_THROW(dd->makeTwoQuditGateDD(cx, 4, 0, 1), std::invalid_argument);
+    EXPECT_THROW(dd->makeTwoQuditGateDD(cx, 4, 0, 0), std::invalid_argument);
+    EXPECT_THROW(dd->makeTwoQuditGateDD(cx, 4, control01, 0, 2), std::invalid_argument);
+}
+
+TEST(DDPackageTest, GateFusion) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 3, 3});
+
+    auto toVector = [](const dd::TritMatrix& mat) { return std::vector<dd::ComplexValue>(mat.begin(), mat.end()); };
+
+    std::vector<dd::Operation> circuit{};
+    circuit.push_back({toVector(dd::H3()), {0}, {}});
+    circuit.push_back({toVector(dd::X3), {1}, {}});
+    circuit.push_back({toVector(dd::RXY3(dd::PI_4, dd::PI_2, 0, 2)), {0}, {}});
+    circuit.push_back({toVector(dd::Z01), {0}, {}});
+    circuit.push_back({toVector(dd::X3), {1}, {{0, 2}}});
+    circuit.push_back({toVector(dd::H3()), {2}, {}});
+    circuit.push_back({toVector(dd::X3dag), {2}, {}});
+    circuit.push_back({toVector(dd::H3()), {1}, {{0, 2}}});
+
+    // H3, RXY3 and Z01 on register 0 merge into one gate, the controlled gates share their registers
+    auto fused = dd::fuseOperations(circuit);
+    EXPECT_EQ(fused.size(), 4U);
+
+    auto initial  = dd->makeBasisState(3, {0, 0, 0});
+    auto expected = dd->applyOperations(circuit, initial, false);
+    auto result   = dd->applyOperations(circuit, initial);
+    EXPECT_NEAR(dd->fidelity(expected, result), 1.0, dd::ComplexTable<>::tolerance());
+    EXPECT_TRUE(result.weight.approximatelyEquals(expected.weight));
+
+    EXPECT_THROW(dd->makeOperationDD({toVector(dd::X3), {}, {}}, 3), std::invalid_argument);
+    EXPECT_THROW(dd->makeOperationDD({std::vector<dd::ComplexValue>(dd::Xmat.begin(), dd::Xmat.end()), {0}, {}}, 3), std::invalid_argument);
+}
+
+TEST(DDPackageTest, CircuitUnitary) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{2, 3, 3});
+
+    auto toVector = [](const auto& mat) { return std::vector<dd::ComplexValue>(mat.begin(), mat.end()); };
+
+    std::vector<dd::Operation> circuit{};
+    circuit.push_back({toVector(dd::Hmat), {0}, {}});
+    circuit.push_back({toVector(dd::H3()), {1}, {}});
+    circuit.push_back({toVector(dd::X3), {2}, {{0, 1}}});
+    circuit.push_back({toVector(dd::RXY3(dd::PI_4, dd::PI_2, 0, 2)), {1}, {}});
+    circuit.push_back({toVector(dd::X3), {2}, {{1, 2}}});
+    circuit.push_back({toVector(dd::H3()), {2}, {}});
+    circuit.push_back({toVector(dd::Z01), {1}, {{0, 0}}});
+
+    dd::MDDPackage::UnitaryStatistics sequentialStatistics{};
+    auto sequential = dd->buildUnitary(circuit, sequentialStatistics, dd::MDDPackage::UnitaryOrder::Sequential);
+    EXPECT_EQ(sequentialStatistics.multiplications, circuit.size() - 1);
+    EXPECT_GT(sequentialStatistics.peakIntermediateNodes, 0U);
+
+    // all orders yield the same DD in the same package
+    dd::MDDPackage::UnitaryStatistics balancedStatistics{};
+    EXPECT_EQ(dd->buildUnitary(circuit, balancedStatistics), sequential);
+    EXPECT_EQ(balancedStatistics.multiplications, circuit.size() - 1);
+    EXPECT_EQ(dd->buildUnitary(circuit, dd::MDDPackage::UnitaryOrder::SizeAware), sequential);
+
+    // slices are built by worker packages in the tables of this package
+    dd::MDDPackage::UnitaryStatistics concurrentStatistics{};
+    auto concurrent = dd->buildUnitary(circuit, concurrentStatistics, dd::MDDPackage::UnitaryOrder::Balanced, 3);
+    EXPECT_EQ(concurrentStatistics.multiplications, circuit.size() - 1);
+    EXPECT_EQ(concurrent, sequential);
+
+    auto fresh = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{2, 3, 3});
+    fresh->buildUnitary(circuit, concurrentStatistics, dd::MDDPackage::UnitaryOrder::Balanced, 3);
+    EXPECT_GT(concurrentStatistics.uniqueTableNodes, 0U);
+    EXPECT_EQ(concurrentStatistics.uniqueTableNodes, fresh->mUniqueTable.getNodeCount());
+
+    auto initial  = dd->makeBasisState(3, {0, 0, 0});
+    auto expected = dd->applyOperations(circuit, initial, false);
+    EXPECT_NEAR(dd->fidelity(dd->multiply(concurrent, initial), expected), 1.0, dd::ComplexTable<>::tolerance());
+    EXPECT_NEAR(dd->fidelity(dd->multiply(sequential, initial), expected), 1.0, dd::ComplexTable<>::tolerance());
+
+    EXPECT_EQ(dd->buildUnitary({}), dd->makeIdent(3));
+}
+
+TEST(DDPackageTest, BlockIdentityShortcuts) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{2, 3, 3});
+
+    auto x3 = dd->makeGateDD<dd::TritMatrix>(dd::X3, 3, 1);
+    EXPECT_TRUE(x3.nextNode->blockIdentity);
+    EXPECT_FALSE(x3.nextNode->identity);
+    EXPECT_FALSE(x3.nextNode->edges.front().nextNode->blockIdentity);
+    EXPECT_TRUE(dd->makeIdent(3).nextNode->blockIdentity);
+
+    // X3 * X3 = X3^dagger, both operands act as identity on the top level
+    EXPECT_EQ(dd->multiply(x3, x3), dd->makeGateDD<dd::TritMatrix>(dd::X3dag, 3, 1));
+
+    // only one operand acts as identity on the respective levels
+    dd::Controls const control01{{0, 1}};
+    auto               h3        = dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 2);
+    auto               cx        = dd->makeGateDD<dd::TritMatrix>(dd::X3, 3, control01, 1);
+    auto               state     = dd->makeBasisState(3, {1, 0, 0});
+    auto               evolution = dd->multiply(h3, dd->multiply(cx, state));
+    EXPECT_NEAR(dd->fidelity(evolution, dd->multiply(dd->multiply(h3, cx), state)), 1.0, dd::ComplexTable<>::tolerance());
+    EXPECT_NEAR(dd->fidelity(evolution, dd->multiply(dd->multiply(cx, h3), state)), 1.0, dd::ComplexTable<>::tolerance());
+
+    // (H3 on register 1)^dagger
+    dd::TritMatrix h3dag{};
+    for (auto row = 0U; row < 3U; row++) {
+        for (auto col = 0U; col < 3U; col++) {
+            const auto entry       = dd::H3().at(col * 3 + row);
+            h3dag.at(row * 3 + col) = {entry.r, -entry.i};
+        }
+    }
+    EXPECT_EQ(dd->conjugateTranspose(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 1)),
+              dd->makeGateDD<dd::TritMatrix>(h3dag, 3, 1));
+
+    // (X3 on register 0 of two qutrits) tensored with H3
+    auto dd3      = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 3, 3});
+    auto upper    = dd3->makeGateDD<dd::TritMatrix>(dd::X3, 2, 0);
+    auto lower    = dd3->makeGateDD<dd::TritMatrix>(dd::H3(), 1, 0);
+    auto expected = dd3->multiply(dd3->makeGateDD<dd::TritMatrix>(dd::X3, 3, 1), dd3->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 0));
+    EXPECT_TRUE(upper.nextNode->blockIdentity);
+    EXPECT_EQ(dd3->kronecker(upper, lower), expected);
+}
+
+TEST(DDPackageTest, SparseSuccessors) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{5, 2, 5});
+
+    // permutation on a ququint: 5 of 25 successors are nonzero
+    auto x5 = dd->makeGateDD<dd::QuintMatrix>(dd::X5, 3, 2);
+    EXPECT_EQ(x5.nextNode->nonZeroEdges.size(), 5U);
+    EXPECT_EQ(x5.nextNode->edges.at(4).nextNode->nonZeroEdges, (std::vector<std::uint16_t>{0, 3}));
+
+    auto power = x5;
+    for (auto i = 1U; i < 5U; i++) {
+        power = dd->multiply(x5, power);
+    }
+    EXPECT_EQ(power, dd->makeIdent(3));
+
+    // controlled permutation followed by a dense gate on a different register
+    dd::Controls const control03{{0, 3}};
+    auto               cx5   = dd->makeGateDD<dd::QuintMatrix>(dd::X5, 3, control03, 2);
+    auto               h5    = dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 0);
+    auto               state = dd->multiply(cx5, dd->multiply(h5, dd->makeBasisState(3, {0, 1, 0})));
+    EXPECT_EQ(state.nextNode->nonZeroEdges, (std::vector<std::uint16_t>{0, 1}));
+
+    auto combined = dd->multiply(dd->multiply(cx5, h5), dd->makeBasisState(3, {0, 1, 0}));
+    EXPECT_NEAR(dd->fidelity(state, combined), 1.0, dd::ComplexTable<>::tolerance());
+    EXPECT_NEAR(dd->fidelity(state, dd->makeBasisState(3, {3, 1, 1})), 0.2, dd::ComplexTable<>::tolerance());
+    EXPECT_NEAR(dd->fidelity(state, dd->makeBasisState(3, {3, 1, 0})), 0.0, dd::ComplexTable<>::tolerance());
+
+    auto sum = dd->add(state, dd->makeBasisState(3, {3, 1, 1}));
+    EXPECT_EQ(sum.nextNode->nonZeroEdges, (std::vector<std::uint16_t>{0, 1}));
+}
+
+TEST(DDPackageTest, ParallelMultiplication) {
+    auto dd = std::make_unique<dd::MDDPackage>(4, std::vector<std::size_t>{3, 2, 5, 3});
+
+    dd::Controls const control01{{0, 1}};
+    dd::Controls const control32{{3, 2}};
+    auto               h5    = dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 4, 2);
+    auto               h3    = dd->makeGateDD<dd::TritMatrix>(dd::H3(), 4, 3);
+    auto               cx5   = dd->makeGateDD<dd::QuintMatrix>(dd::X5, 4, control01, 2);
+    auto               cx3   = dd->makeGateDD<dd::TritMatrix>(dd::X3, 4, control32, 0);
+    auto               state = dd->multiply(h3, dd->multiply(h5, dd->makeBasisState(4, {1, 1, 0, 0})));
+
+    for (const std::size_t levels: {1U, 2U, 4U}) {
+        auto expected = dd->multiply(cx3, dd->multiply(cx5, state));
+        auto result   = dd->multiplyParallel(cx3, dd->multiplyParallel(cx5, state, 4, levels), 4, levels);
+        EXPECT_NEAR(dd->fidelity(result, expected), 1.0, dd::ComplexTable<>::tolerance());
+        EXPECT_TRUE(result.weight.approximatelyEquals(expected.weight));
+
+        auto product = dd->multiplyParallel(cx3, dd->multiplyParallel(h3, cx5, 3, levels), 3, levels);
+        EXPECT_EQ(product, dd->multiply(cx3, dd->multiply(h3, cx5)));
+    }
+
+    // a single thread falls back to the sequential multiplication
+    EXPECT_EQ(dd->multiplyParallel(cx5, state, 1), dd->multiply(cx5, state));
+}
+
+TEST(DDPackageTest, SharedUniqueTables) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    auto build = [](dd::MDDPackage& pkg) {
+        dd::Controls const control{{1, 1}};
+        auto               h5    = pkg.makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2);
+        auto               cx3   = pkg.makeGateDD<dd::TritMatrix>(dd::X3, 3, control, 0);
+        auto               state = pkg.makeBasisState(3, {2, 1, 0});
+        return pkg.multiply(cx3, pkg.multiply(h5, state));
+    };
+    const auto expected = build(*dd);
+    const auto nodes    = dd->vUniqueTable.getNodeCount() + dd->mUniqueTable.getNodeCount();
+
+    // threads hash-consing the same DDs into the shared tables end up with the nodes of the original package
+    std::vector<std::unique_ptr<dd::MDDPackage>> workers{};
+    for (auto i = 0U; i < 4U; ++i) {
+        workers.push_back(std::make_unique<dd::MDDPackage>(*dd, dd::MDDPackage::SharedTables{}));
+    }
+    std::vector<std::future<dd::MDDPackage::vEdge>> results{};
+    for (auto& worker: workers) {
+        results.push_back(std::async(std::launch::async, [&worker, &build]() { return build(*worker); }));
+    }
+    for (auto& result: results) {
+        EXPECT_EQ(result.get(), expected);
+    }
+    EXPECT_EQ(dd->vUniqueTable.getNodeCount() + dd->mUniqueTable.getNodeCount(), nodes);
+    EXPECT_EQ(workers.front()->vUniqueTable.getNodeCount(), dd->vUniqueTable.getNodeCount());
+    EXPECT_GE(dd->vUniqueTable.threads(), 1U);
+
+    // nodes created by a worker are used by the original package
+    auto worker = std::make_unique<dd::MDDPackage>(*dd, dd::MDDPackage::SharedTables{});
+    auto x5     = worker->makeGateDD<dd::QuintMatrix>(dd::X5, 3, 2);
+    EXPECT_EQ(dd->makeGateDD<dd::QuintMatrix>(dd::X5, 3, 2), x5);
+    EXPECT_NEAR(dd->fidelity(dd->multiply(x5, expected), worker->multiply(x5, expected)), 1.0, dd::ComplexTable<>::tolerance());
+
+    // nodes are never collected, reference counting leaves the tables untouched
+    const auto sharedNodes = dd->vUniqueTable.getNodeCount();
+    dd->incRef(expected);
+    dd->decRef(expected);
+    dd->decRef(expected);
+    EXPECT_EQ(dd->vUniqueTable.getNodeCount(), sharedNodes);
+    EXPECT_EQ(dd->multiply(x5, expected), worker->multiply(x5, expected));
+}
+
+TEST(DDPackageTest, ConcurrentComplexTable) {
+    dd::ConcurrentComplexTable<> table{};
+    const auto                   initialCount = table.getCount();
+
+    // values spread over all shards, including ones at the borders between buckets
+    std::vector<dd::fp> values{};
+    for (auto i = 1U; i < 2000U; ++i) {
+        values.push_back(static_cast<dd::fp>(i) / 1999. * 0.999);
+    }
+    values.push_back(0.5 / static_cast<dd::fp>(dd::ConcurrentComplexTable<>::MASK));
+
+    std::vector<std::future<std::vector<dd::CTEntry*>>> results{};
+    for (auto t = 0U; t < 4U; ++t) {
+        results.push_back(std::async(std::launch::async, [&table, &values, t]() {
+            std::vector<dd::CTEntry*> entries(values.size());
+            // every thread traverses the values in a different order
+            for (auto i = 0U; i < values.size(); ++i) {
+                const auto idx = (t % 2 == 0) ? i : values.size() - 1 - i;
+                entries.at(idx) = table.lookup(values.at(idx));
+            }
+            return entries;
+        }));
+    }
+    const auto entries = results.front().get();
+    for (auto t = 1U; t < results.size(); ++t) {
+        EXPECT_EQ(results.at(t).get(), entries);
+    }
+
+    // every value was inserted exactly once
+    const auto distinct = static_cast<std::size_t>(std::count_if(entries.begin(), entries.end(), [](const dd::CTEntry* e) {
+        return e != &dd::ComplexTable<>::zero && e != &dd::ComplexTable<>::one && e != &dd::ComplexTable<>::sqrt2_2 && e->value != 0.5;
+    }));
+    EXPECT_EQ(table.getCount(), initialCount + distinct);
+    for (auto i = 0U; i < values.size(); ++i) {
+        EXPECT_TRUE(dd::CTEntry::approximatelyEquals(entries.at(i)->value, values.at(i)));
+        EXPECT_EQ(table.lookup(values.at(i) + dd::ComplexTable<>::tolerance() / 4), entries.at(i));
+    }
+
+    // complex numbers sharing a table look up the same entries
+    dd::ComplexNumbers cn{};
+    dd::ComplexNumbers shared{cn};
+    EXPECT_EQ(cn.lookup(0.3, -0.7), shared.lookup(0.3, -0.7));
+    EXPECT_NE(cn.getCached(0.3, -0.7), shared.getCached(0.3, -0.7));
+}
+
+TEST(DDPackageTest, BatchedMultiplication) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    dd::Controls const control{{1, 1}};
+    auto               gate = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::X3, 3, control, 0),
+                                           dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2));
+
+    std::vector<dd::MDDPackage::vEdge> states{};
+    states.push_back(dd->makeBasisState(3, {0, 1, 2}));
+    states.push_back(dd->makeBasisState(3, {2, 1, 4}));
+    states.push_back(dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 0), states.front()));
+    // same root node as the first state with another weight
+    states.push_back({states.front().nextNode, dd->complexNumber.lookup(0., -1.)});
+    states.push_back(dd::MDDPackage::vEdge::zero);
+
+    dd::MDDPackage::BatchStatistics statistics{};
+    const auto                      results = dd->multiplyBatch(gate, states, statistics);
+    ASSERT_EQ(results.size(), states.size());
+    for (auto i = 0U; i + 1 < states.size(); ++i) {
+        const auto expected = dd->multiply(gate, states.at(i));
+        EXPECT_EQ(results.at(i).nextNode, expected.nextNode);
+        EXPECT_TRUE(results.at(i).weight.approximatelyEquals(expected.weight));
+    }
+    EXPECT_EQ(results.back(), dd::MDDPackage::vEdge::zero);
+
+    EXPECT_EQ(statistics.states, states.size());
+    EXPECT_EQ(statistics.distinctStates, 3U);
+    EXPECT_GT(statistics.computeTableLookups, 0U);
+    EXPECT_LE(statistics.computeTableHits, statistics.computeTableLookups);
+    // every gate node is expanded once for all states reaching it
+    EXPECT_GT(statistics.gateNodeVisits, 0U);
+    EXPECT_LT(statistics.gateNodeVisits, statistics.operandVisits);
+
+    // a second pass over the batch reuses all sub-products
+    dd->multiplyBatch(gate, states, statistics);
+    EXPECT_GT(statistics.computeTableHits, 0U);
+    EXPECT_EQ(statistics.gateNodeVisits, 0U);
+
+    // a batch of all basis states shares the gate traversal on every level
+    auto                               other = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+    const auto                         h     = other->multiply(other->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 0), other->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2));
+    std::vector<dd::MDDPackage::vEdge> basis{};
+    for (auto i = 0U; i < other->stateDimension(); ++i) {
+        basis.push_back(other->makeBasisState(3, {i % 3, (i / 3) % 2, i / 6}));
+    }
+    const auto products = other->multiplyBatch(h, basis, statistics);
+    EXPECT_EQ(statistics.distinctStates, basis.size());
+    EXPECT_LT(statistics.gateNodeVisits * 4, statistics.operandVisits);
+    for (auto i = 0U; i < basis.size(); ++i) {
+        EXPECT_EQ(products.at(i), other->multiply(h, basis.at(i)));
+    }
+
+    EXPECT_THROW(dd->multiplyBatch(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 2, 0), states), std::invalid_argument);
+}
+
+TEST(DDPackageTest, AddTableKeyedOnWeightRatio) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    auto a = dd->multiply(dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2), dd->makeBasisState(3, {1, 0, 0}));
+    auto b = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 0), dd->makeBasisState(3, {0, 1, 3}));
+
+    auto scaled = [&dd](const dd::MDDPackage::vEdge& e, const dd::ComplexValue& factor) {
+        return dd::MDDPackage::vEdge{e.nextNode, dd->complexNumber.lookup(dd::ComplexValue{dd::CTEntry::val(e.weight.real), dd::CTEntry::val(e.weight.img)} * factor)};
+    };
+
+    const dd::ComplexValue wa{0.6, 0.};
+    const dd::ComplexValue wb{0., 0.8};
+    const auto             sum = dd->add(scaled(a, wa), scaled(b, wb));
+
+    // the same addition up to a common factor is answered by the table at the top level
+    const dd::ComplexValue factor{-0.3, 0.7};
+    const auto             hits   = dd->vectorAdd.getHits();
+    const auto             result = dd->add(scaled(a, wa * factor), scaled(b, wb * factor));
+    EXPECT_EQ(dd->vectorAdd.getHits(), hits + 1);
+    EXPECT_EQ(result.nextNode, sum.nextNode);
+    EXPECT_TRUE(result.weight.approximatelyEquals(scaled(sum, factor).weight));
+
+    // operands in swapped order share the entry as well
+    const auto swapped = dd->add(scaled(b, wb), scaled(a, wa));
+    EXPECT_EQ(dd->vectorAdd.getHits(), hits + 2);
+    EXPECT_EQ(swapped, sum);
+
+    // and the results agree with an addition in a fresh package
+    auto fresh = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+    auto fa    = fresh->multiply(fresh->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2), fresh->makeBasisState(3, {1, 0, 0}));
+    auto fb    = fresh->multiply(fresh->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 0), fresh->makeBasisState(3, {0, 1, 3}));
+    auto fsum  = fresh->add(dd::MDDPackage::vEdge{fa.nextNode, fresh->complexNumber.lookup(wa * factor)},
+                            dd::MDDPackage::vEdge{fb.nextNode, fresh->complexNumber.lookup(wb * factor)});
+    EXPECT_NEAR(std::abs(dd::CTEntry::val(fsum.weight.real) - dd::CTEntry::val(result.weight.real)), 0., dd::ComplexTable<>::tolerance());
+    EXPECT_NEAR(std::abs(dd::CTEntry::val(fsum.weight.img) - dd::CTEntry::val(result.weight.img)), 0., dd::ComplexTable<>::tolerance());
+}
+
+TEST(DDPackageTest, ExpectationValue) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    dd::Controls const control{{1, 1}};
+    auto               state = dd->multiply(dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2), dd->makeBasisState(3, {1, 1, 3}));
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, control, 0), state);
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::RXY3(dd::PI_4, dd::PI_2, 0, 2), 3, 0), state);
+
+    auto expected = [&dd](const dd::MDDPackage::mEdge& op, const dd::MDDPackage::vEdge& psi) {
+        const auto           amplitudes = dd->getVector(psi);
+        const auto           image      = dd->getVector(dd->multiply(op, psi));
+        std::complex<dd::fp> sum{};
+        for (auto i = 0U; i < amplitudes.size(); ++i) {
+            sum += std::conj(amplitudes.at(i)) * image.at(i);
+        }
+        return sum;
+    };
+
+    const std::vector<dd::MDDPackage::mEdge> observables{
+            dd->makeGateDD<dd::TritMatrix>(dd::Z01, 3, 0),
+            dd->makeGateDD<dd::TritMatrix>(dd::Pi3(1), 3, 0),
+            dd->makeGateDD<dd::QuintMatrix>(dd::X5, 3, control, 2),
+            dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 0),
+            dd->makeIdent(3)};
+    for (const auto& op: observables) {
+        const auto value = dd->expectationValue(op, state);
+        const auto ref   = expected(op, state);
+        EXPECT_NEAR(value.r, ref.real(), 1e-10);
+        EXPECT_NEAR(value.i, ref.imag(), 1e-10);
+    }
+    // identity yields the norm of the state
+    EXPECT_NEAR(dd->expectationValue(dd->makeIdent(3), state).r, 1., 1e-10);
+
+    // repeated evaluations are answered by the compute table
+    const auto hits = dd->vectorExpectationValue->getHits();
+    dd->expectationValue(observables.front(), state);
+    EXPECT_EQ(dd->vectorExpectationValue->getHits(), hits + 1);
+
+    EXPECT_THROW(dd->expectationValue(observables.front(), dd::MDDPackage::vEdge::one), std::invalid_argument);
+}
+
+TEST(DDPackageTest, Sampling) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    dd::Controls const control{{1, 1}};
+    auto               state = dd->multiply(dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2), dd->makeBasisState(3, {1, 1, 3}));
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::RXY3(dd::PI_4, dd::PI_2, 0, 1), 3, control, 0), state);
+    const auto amplitudes    = dd->getVector(state);
+
+    std::mt19937_64   gen(42); // NOLINT(cert-msc51-cpp): seed the generator with fixed value for reproducibility
+    const std::size_t shots  = 200000;
+    const auto        counts = dd->sample(state, shots, gen);
+
+    std::size_t total = 0;
+    for (const auto& [digits, count]: counts) {
+        ASSERT_EQ(digits.size(), 3U);
+        const auto index       = digits.at(0) + 3 * (digits.at(1) + 2 * digits.at(2));
+        const auto probability = std::norm(amplitudes.at(index));
+        EXPECT_GT(probability, 0.);
+        EXPECT_NEAR(static_cast<double>(count) / shots, probability, 0.01);
+        total += count;
+    }
+    EXPECT_EQ(total, shots);
+    const auto nonZero = std::count_if(amplitudes.begin(), amplitudes.end(), [](const auto& a) { return std::norm(a) > 1e-12; });
+    EXPECT_EQ(counts.size(), static_cast<std::size_t>(nonZero));
+    EXPECT_NEAR(dd->subtreeNorm(state.nextNode), 1., 1e-10);
+    EXPECT_THROW(dd->sample(dd::MDDPackage::vEdge::zero, 1, gen), std::invalid_argument);
+
+    // GHZ state of 60 qutrits, whose basis states cannot be indexed by 64 bits
+    const std::size_t n     = 60;
+    auto              large = std::make_unique<dd::MDDPackage>(n, std::vector<std::size_t>(n, 3));
+    auto              ghz   = large->add(large->add(large->makeBasisState(n, std::vector<std::size_t>(n, 0)),
+                                                    large->makeBasisState(n, std::vector<std::size_t>(n, 1))),
+                                         large->makeBasisState(n, std::vector<std::size_t>(n, 2)));
+    ghz.weight              = large->complexNumber.lookup(dd::CTEntry::val(ghz.weight.real) * dd::SQRT3_3, 0.);
+
+    const auto ghzCounts = large->sample(ghz, 1000000, gen);
+    ASSERT_EQ(ghzCounts.size(), 3U);
+    for (const auto& [digits, count]: ghzCounts) {
+        EXPECT_EQ(digits, std::vector<std::size_t>(n, digits.front()));
+        EXPECT_NEAR(static_cast<double>(count) / 1000000., 1. / 3., 0.005);
+    }
+}
+
+TEST(DDPackageTest, MeasureOneCollapsing) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    dd::Controls const control{{2, 1}};
+    auto               state = dd->multiply(dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2), dd->makeBasisState(3, {0, 1, 3}));
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, control, 0), state);
+    const auto amplitudes    = dd->getVector(state);
+
+    // outcome probabilities of the qutrit agree with the amplitudes
+    const auto probabilities = dd->measurementProbabilities(state, 0);
+    ASSERT_EQ(probabilities.size(), 3U);
+    for (auto k = 0U; k < 3U; ++k) {
+        dd::fp expected = 0.;
+        for (auto index = k; index < amplitudes.size(); index += 3) {
+            expected += std::norm(amplitudes.at(index));
+        }
+        EXPECT_NEAR(probabilities.at(k), expected, 1e-10);
+    }
+    EXPECT_THROW(dd->measurementProbabilities(state, 3), std::invalid_argument);
+
+    std::mt19937_64 gen(42); // NOLINT(cert-msc51-cpp): seed the generator with fixed value for reproducibility
+    for (auto run = 0U; run < 20U; ++run) {
+        auto       collapsed = state;
+        const auto outcome   = dd->measureOneCollapsing(collapsed, 0, gen);
+        ASSERT_LT(outcome, 3U);
+        EXPECT_GT(probabilities.at(outcome), 0.);
+
+        // the result equals the normalized projection onto the outcome
+        const auto result = dd->getVector(collapsed);
+        for (auto index = 0U; index < amplitudes.size(); ++index) {
+            const auto expected = index % 3 == outcome ? amplitudes.at(index) / std::sqrt(probabilities.at(outcome)) : 0.;
+            EXPECT_NEAR(result.at(index).real(), expected.real(), 1e-10);
+            EXPECT_NEAR(result.at(index).imag(), expected.imag(), 1e-10);
+        }
+
+        // measuring again yields the same outcome with certainty
+        const auto again = dd->measurementProbabilities(collapsed, 0);
+        EXPECT_NEAR(again.at(outcome), 1., 1e-10);
+    }
+}
+
+TEST(DDPackageTest, Marginals) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    dd::Controls const control{{2, 1}};
+    auto               state = dd->multiply(dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2), dd->makeBasisState(3, {0, 1, 3}));
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, control, 0), state);
+    state                    = dd->multiply(dd->makeGateDD<dd::GateMatrix>(dd::Hmat, 3, 1), state);
+    const auto amplitudes    = dd->getVector(state);
+
+    // joint distribution of the ququint and the qutrit with the ququint as least significant digit
+    const auto joint = dd->marginals(state, {2, 0});
+    ASSERT_EQ(joint.size(), 15U);
+    std::vector<dd::fp> expected(15, 0.);
+    for (auto index = 0U; index < amplitudes.size(); ++index) {
+        expected.at(index / 6 + 5 * (index % 3)) += std::norm(amplitudes.at(index));
+    }
+    for (auto i = 0U; i < expected.size(); ++i) {
+        EXPECT_NEAR(joint.at(i), expected.at(i), 1e-10);
+    }
+
+    const auto single = dd->marginals(state, {0});
+    const auto probabilities = dd->measurementProbabilities(state, 0);
+    ASSERT_EQ(single.size(), probabilities.size());
+    for (auto i = 0U; i < single.size(); ++i) {
+        EXPECT_NEAR(single.at(i), probabilities.at(i), 1e-10);
+    }
+    EXPECT_NEAR(dd->marginals(state, {}).at(0), 1., 1e-10);
+    EXPECT_THROW(dd->marginals(state, {1, 1}), std::invalid_argument);
+    EXPECT_THROW(dd->marginals(state, {3}), std::invalid_argument);
+
+    // GHZ state of 60 qutrits: the outer qutrits are perfectly correlated
+    const std::size_t n     = 60;
+    auto              large = std::make_unique<dd::MDDPackage>(n, std::vector<std::size_t>(n, 3));
+    auto              ghz   = large->add(large->add(large->makeBasisState(n, std::vector<std::size_t>(n, 0)),
+                                                    large->makeBasisState(n, std::vector<std::size_t>(n, 1))),
+                                         large->makeBasisState(n, std::vector<std::size_t>(n, 2)));
+    ghz.weight              = large->complexNumber.lookup(dd::CTEntry::val(ghz.weight.real) * dd::SQRT3_3, 0.);
+    const auto outer        = large->marginals(ghz, {0, 59});
+    ASSERT_EQ(outer.size(), 9U);
+    for (auto i = 0U; i < 3U; ++i) {
+        for (auto j = 0U; j < 3U; ++j) {
+            EXPECT_NEAR(outer.at(i + 3 * j), i == j ? 1. / 3. : 0., 1e-10);
+        }
+    }
+}
+
+TEST(DDPackageTest, DensityMatrices) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    dd::Controls const control{{2, 1}};
+    const auto         h5    = dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2);
+    const auto         ch3   = dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, control, 0);
+    const auto         rxy   = dd->makeGateDD<dd::TritMatrix>(dd::RXY3(dd::PI_4, dd::PI_2, 0, 2), 3, 0);
+    const auto         cnot  = dd->makeGateDD<dd::GateMatrix>(dd::Xmat, 3, dd::Controls{{0, 1}}, 1);
+    const auto         input = dd->makeBasisState(3, {0, 0, 1});
+
+    // applying gates to the density matrix agrees with the density matrix of the evolved state
+    auto rho   = dd->makeDensityMatrix(input);
+    auto state = input;
+    for (const auto& gate: {h5, ch3, rxy, cnot}) {
+        rho   = dd->applyUnitary(gate, rho);
+        state = dd->multiply(gate, state);
+    }
+    const auto expected = dd->makeDensityMatrix(state);
+    EXPECT_EQ(rho.nextNode, expected.nextNode);
+    EXPECT_TRUE(rho.weight.approximatelyEquals(expected.weight));
+
+    const auto trace = dd->trace(rho);
+    EXPECT_NEAR(trace.r, 1., 1e-10);
+    EXPECT_NEAR(trace.i, 0., 1e-10);
+    EXPECT_NEAR(dd->purity(rho), 1., 1e-10);
+
+    // equal mixture of two orthogonal states
+    const auto half = [&dd](const dd::MDDPackage::dEdge& e) {
+        return dd::MDDPackage::dEdge{e.nextNode, dd->complexNumber.lookup(dd::CTEntry::val(e.weight.real) * 0.5, dd::CTEntry::val(e.weight.img) * 0.5)};
+    };
+    const auto mixed = dd->add(half(dd->makeDensityMatrix(input)), half(dd->makeDensityMatrix(dd->makeBasisState(3, {1, 0, 1}))));
+    EXPECT_NEAR(dd->trace(mixed).r, 1., 1e-10);
+    EXPECT_NEAR(dd->purity(mixed), 0.5, 1e-10);
+    EXPECT_NEAR(dd->purity(dd->applyUnitary(h5, mixed)), 0.5, 1e-10);
+
+    // purity of the reduced density matrix of every single register agrees with the dense computation
+    const auto                     amplitudes = dd->getVector(state);
+    const std::vector<std::size_t> dims{3, 2, 5};
+    const std::vector<std::size_t> strides{1, 3, 6};
+    for (auto reg = 0U; reg < 3U; ++reg) {
+        std::vector<dd::QuantumRegister> others{};
+        for (auto other = 0U; other < 3U; ++other) {
+            if (other != reg) {
+                others.push_back(static_cast<dd::QuantumRegister>(other));
+            }
+        }
+        const auto reduced = dd->partialTrace(rho, others);
+        ASSERT_FALSE(reduced.isTerminal());
+        EXPECT_EQ(reduced.nextNode->varIndx, 0);
+        EXPECT_NEAR(dd->trace(reduced).r, 1., 1e-10);
+
+        dd::fp purity = 0.;
+        for (auto a = 0U; a < dims.at(reg); ++a) {
+            for (auto b = 0U; b < dims.at(reg); ++b) {
+                std::complex<dd::fp> entry{};
+                for (auto index = 0U; index < amplitudes.size(); ++index) {
+                    if ((index / strides.at(reg)) % dims.at(reg) == a) {
+                        entry += amplitudes.at(index) * std::conj(amplitudes.at(index - a * strides.at(reg) + b * strides.at(reg)));
+                    }
+                }
+                purity += std::norm(entry);
+            }
+        }
+        EXPECT_NEAR(dd->purity(reduced), purity, 1e-10);
+    }
+    EXPECT_LT(dd->purity(dd->partialTrace(rho, {0, 2})), 1. - 1e-3);
+
+    const auto scalar = dd->partialTrace(rho, {0, 1, 2});
+    EXPECT_TRUE(scalar.isTerminal());
+    EXPECT_NEAR(dd::CTEntry::val(scalar.weight.real), 1., 1e-10);
+    EXPECT_THROW(dd->partialTrace(rho, {1, 1}), std::invalid_argument);
+}
+
+TEST(DDPackageTest, DensityMatricesOnStack) {
+    // the package keeps its density and other additional compute tables on the heap, i.e., it fits on the stack
+    dd::MDDPackage dd(2, std::vector<std::size_t>{2, 3});
+
+    const auto rho = dd.makeDensityMatrix(dd.makeBasisState(2, {1, 2}));
+    const auto out = dd.applyUnitary(dd.makeGateDD<dd::TritMatrix>(dd::H3(), 2, 1), rho);
+    EXPECT_NEAR(dd.trace(out).r, 1., 1e-10);
+    EXPECT_NEAR(dd.purity(out), 1., 1e-10);
+}
+
+TEST(DDPackageTest, NoiseTrajectories) {
+    auto dd = std::make_unique<dd::MDDPackage>(2, std::vector<std::size_t>{3, 2});
+
+    const auto identity = [](std::size_t dim) {
+        std::vector<dd::ComplexValue> matrix(dim * dim, dd::ComplexValue{0., 0.});
+        for (auto k = 0U; k < dim; ++k) {
+            matrix.at(k * dim + k) = {1., 0.};
+        }
+        return matrix;
+    };
+    const std::vector<dd::Operation> idle{{identity(3), {0}, {}}};
+    const auto                       p0 = dd->makeGateDD<dd::TritMatrix>(dd::Pi3(0), 2, 0);
+
+    // without noise every trajectory agrees with the ideal simulation
+    const auto                       h3 = dd::H3();
+    const std::vector<dd::Operation> circuit{{std::vector<dd::ComplexValue>(h3.begin(), h3.end()), {0}, {}},
+                                             {std::vector<dd::ComplexValue>(dd::Xmat.begin(), dd::Xmat.end()), {1}, {{0, 1}}}};
+    const auto                       initial = dd->makeBasisState(2, {0, 0});
+    const auto                       ideal   = dd->applyOperations(circuit, initial, false);
+
+    dd::MDDPackage::TrajectorySettings settings{};
+    settings.trajectories       = 100;
+    settings.shotsPerTrajectory = 10;
+    settings.threads            = 2;
+    settings.seed               = 42;
+    const auto noiseless        = dd->simulateTrajectories(circuit, initial, {}, {p0}, settings);
+    EXPECT_NEAR(noiseless.expectationValues.at(0).r, dd->expectationValue(p0, ideal).r, 1e-10);
+    std::size_t total = 0;
+    for (const auto& [digits, count]: noiseless.counts) {
+        EXPECT_EQ(digits.at(1), digits.at(0) == 1 ? 1U : 0U);
+        total += count;
+    }
+    EXPECT_EQ(total, 1000U);
+
+    // full level decay moves |2> to |1>
+    dd::NoiseModel damping{};
+    damping.amplitudeDamping = 1.;
+    const auto decayed       = dd->simulateTrajectories(idle, dd->makeBasisState(2, {2, 0}), damping, {}, settings);
+    ASSERT_EQ(decayed.counts.size(), 1U);
+    EXPECT_EQ(decayed.counts.begin()->first, (std::vector<std::size_t>{1, 0}));
+
+    // a certain depolarizing error leaves |0> with probability (d - 1) / (d^2 - 1) = 1 / 4
+    dd::NoiseModel depolarizing{};
+    depolarizing.depolarization = 1.;
+    settings.trajectories       = 4000;
+    settings.shotsPerTrajectory = 1;
+    const auto depolarized      = dd->simulateTrajectories(idle, initial, depolarizing, {p0}, settings);
+    EXPECT_NEAR(depolarized.expectationValues.at(0).r, 0.25, 0.03);
+
+    // results do not depend on the number of threads
+    settings.threads         = 1;
+    const auto sequential    = dd->simulateTrajectories(idle, initial, depolarizing, {p0}, settings);
+    EXPECT_EQ(sequential.counts, depolarized.counts);
+    EXPECT_NEAR(sequential.expectationValues.at(0).r, depolarized.expectationValues.at(0).r, 1e-10);
+
+    depolarizing.dephasing = 1.5;
+    EXPECT_THROW(dd->simulateTrajectories(idle, initial, depolarizing, {p0}, settings), std::invalid_argument);
+    depolarizing.dephasing = 0.;
+    settings.trajectories  = 0;
+    EXPECT_THROW(dd->simulateTrajectories(idle, initial, depolarizing, {p0}, settings), std::invalid_argument);
+
+    // a register with a single level admits no errors
+    auto                             single = std::make_unique<dd::MDDPackage>(2, std::vector<std::size_t>{3, 1});
+    const std::vector<dd::Operation> trivial{{identity(1), {1}, {{0, 0}}}};
+    depolarizing.dephasing      = 1.;
+    settings.trajectories       = 10;
+    const auto undisturbed      = single->simulateTrajectories(trivial, single->makeBasisState(2, {1, 0}), depolarizing, {}, settings);
+    total = 0;
+    for (const auto& [digits, count]: undisturbed.counts) {
+        EXPECT_EQ(digits.at(1), 0U);
+        total += count;
+    }
+    EXPECT_EQ(total, 10U);
+}
+
+TEST(DDPackageTest, VectorExtractionIntoBuffers) {
+    auto dd = std::make_unique<dd::MDDPackage>(4, std::vector<std::size_t>{3, 2, 5, 3});
+
+    dd::Controls const control{{2, 1}};
+    auto               state = dd->multiply(dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 4, 2), dd->makeBasisState(4, {0, 1, 3, 2}));
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 4, control, 0), state);
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::RXY3(dd::PI_4, dd::PI_2, 0, 2), 4, 3), state);
+
+    // reference by following the path of every index
+    const auto dim = dd->stateDimension();
+    ASSERT_EQ(dim, 90U);
+    std::vector<std::complex<dd::fp>> expected(dim);
+    for (auto i = 0U; i < dim; ++i) {
+        auto       repr  = dd->getReprOfIndex(i, dim);
+        const auto value = dd->getValueByPath(state, repr);
+        expected.at(i)   = {value.r, value.i};
+    }
+
+    const auto check = [&expected](const std::complex<dd::fp>* data, std::size_t first, std::size_t count) {
+        for (auto i = 0U; i < count; ++i) {
+            EXPECT_NEAR(data[i].real(), expected.at(first + i).real(), 1e-12);
+            EXPECT_NEAR(data[i].imag(), expected.at(first + i).imag(), 1e-12);
+        }
+    };
+
+    const auto vec = dd->getVector(state);
+    check(vec.data(), 0, dim);
+
+    // the buffer is overwritten entirely, also by concurrent extraction
+    std::vector<std::complex<dd::fp>> buffer(dim, {7., 7.});
+    dd->getVector(state, buffer.data(), buffer.size(), 4);
+    check(buffer.data(), 0, dim);
+    EXPECT_THROW(dd->getVector(state, buffer.data(), dim - 1), std::invalid_argument);
+
+    std::vector<std::complex<dd::fp>> range(17, {7., 7.});
+    dd->getVectorRange(state, 41, range.size(), range.data());
+    check(range.data(), 41, range.size());
+    EXPECT_THROW(dd->getVectorRange(state, 80, 11, range.data()), std::invalid_argument);
+
+    std::size_t streamed = 0;
+    dd->streamVector(state, 16, [&](std::size_t first, const std::complex<dd::fp>* data, std::size_t count) {
+        EXPECT_EQ(first, streamed);
+        EXPECT_LE(count, 16U);
+        check(data, first, count);
+        streamed += count;
+    });
+    EXPECT_EQ(streamed, dim);
+
+    // the dimension of 64 qutrits does not fit into 64 bits
+    auto large = std::make_unique<dd::MDDPackage>(64, std::vector<std::size_t>(64, 3));
+    EXPECT_THROW(large->getVector(large->makeBasisState(64, std::vector<std::size_t>(64, 0))), std::overflow_error);
+}
+
+TEST(DDPackageTest, NonZeroAmplitudeIterator) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    dd::Controls const control{{2, 1}};
+    auto               state = dd->multiply(dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2), dd->makeBasisState(3, {0, 1, 3}));
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, control, 0), state);
+    const auto amplitudes    = dd->getVector(state);
+
+    // the iterator visits exactly the nonzero amplitudes in ascending order
+    auto it = dd->nonZeroAmplitudes(state).begin();
+    for (auto index = 0U; index < amplitudes.size(); ++index) {
+        if (std::norm(amplitudes.at(index)) < 1e-20) {
+            continue;
+        }
+        ASSERT_NE(it, dd->nonZeroAmplitudes(state).end());
+        EXPECT_EQ(it->index, index);
+        EXPECT_EQ(it->digits, (std::vector<std::size_t>{index % 3, (index / 3) % 2, index / 6}));
+        EXPECT_NEAR(it->amplitude.r, amplitudes.at(index).real(), 1e-12);
+        EXPECT_NEAR(it->amplitude.i, amplitudes.at(index).imag(), 1e-12);
+        ++it;
+    }
+    EXPECT_EQ(it, dd->nonZeroAmplitudes(state).end());
+    EXPECT_EQ(dd->nonZeroAmplitudes(dd::MDDPackage::vEdge::zero).begin(), dd->nonZeroAmplitudes(dd::MDDPackage::vEdge::zero).end());
+
+    testing::internal::CaptureStdout();
+    dd->printVector(dd->makeBasisState(3, {2, 1, 4}), true);
+    EXPECT_EQ(testing::internal::GetCapturedStdout().substr(0, 5), "412: ");
+
+    testing::internal::CaptureStdout();
+    dd->printVector(state);
+    const auto printed = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(static_cast<std::size_t>(std::count(printed.begin(), printed.end(), '\n')), amplitudes.size());
+
+    // a GHZ state of 60 qutrits has three nonzero amplitudes
+    const std::size_t n     = 60;
+    auto              large = std::make_unique<dd::MDDPackage>(n, std::vector<std::size_t>(n, 3));
+    auto              ghz   = large->add(large->add(large->makeBasisState(n, std::vector<std::size_t>(n, 0)),
+                                                    large->makeBasisState(n, std::vector<std::size_t>(n, 1))),
+                                         large->makeBasisState(n, std::vector<std::size_t>(n, 2)));
+    ghz.weight              = large->complexNumber.lookup(dd::CTEntry::val(ghz.weight.real) * dd::SQRT3_3, 0.);
+    std::size_t level       = 0;
+    for (const auto& entry: large->nonZeroAmplitudes(ghz)) {
+        EXPECT_EQ(entry.digits, std::vector<std::size_t>(n, level));
+        EXPECT_NEAR(entry.amplitude.r, dd::SQRT3_3, 1e-12);
+        ++level;
+    }
+    EXPECT_EQ(level, 3U);
+}
+
+TEST(DDPackageTest, BatchedAmplitudes) {
+    auto dd = std::make_unique<dd::MDDPackage>(4, std::vector<std::size_t>{3, 2, 5, 3});
+
+    dd::Controls const control{{2, 1}};
+    auto               state = dd->multiply(dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 4, 2), dd->makeBasisState(4, {0, 1, 3, 2}));
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 4, control, 0), state);
+    state                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::RXY3(dd::PI_4, dd::PI_2, 0, 2), 4, 3), state);
+    const auto amplitudes    = dd->getVector(state);
+
+    // unsorted requests with duplicates
+    std::mt19937_64                            gen(42); // NOLINT(cert-msc51-cpp): seed the generator with fixed value for reproducibility
+    std::uniform_int_distribution<std::size_t> distribution(0, amplitudes.size() - 1);
+    std::vector<std::size_t>                   indices(500);
+    for (auto& index: indices) {
+        index = distribution(gen);
+    }
+    indices.push_back(0);
+    indices.push_back(amplitudes.size() - 1);
+
+    const auto values = dd->getAmplitudes(state, indices);
+    ASSERT_EQ(values.size(), indices.size());
+    for (auto i = 0U; i < indices.size(); ++i) {
+        EXPECT_NEAR(values.at(i).r, amplitudes.at(indices.at(i)).real(), 1e-12);
+        EXPECT_NEAR(values.at(i).i, amplitudes.at(indices.at(i)).imag(), 1e-12);
+
+        // paths list the levels from the root down
+        const auto path = dd->getReprOfIndex(indices.at(i), amplitudes.size());
+        EXPECT_TRUE(dd->getValueByPath(state, path).approximatelyEquals(values.at(i)));
+    }
+    EXPECT_TRUE(dd->getAmplitudes(state, {}).empty());
+    EXPECT_THROW(dd->getAmplitudes(state, {amplitudes.size()}), std::invalid_argument);
+
+    // entries of a matrix are addressed by row and column paths
+    const auto gate = dd->makeGateDD<dd::TritMatrix>(dd::H3(), 4, control, 0);
+    const auto h3   = dd::H3();
+    for (auto row = 0U; row < 3U; ++row) {
+        for (auto col = 0U; col < 3U; ++col) {
+            EXPECT_TRUE(dd->getValueByPath(gate, {0, 1, 0, row}, {0, 1, 0, col}).approximatelyEquals(h3.at(3 * row + col)));
+            EXPECT_TRUE(dd->getValueByPath(gate, {0, 0, 0, row}, {0, 0, 0, col}).approximatelyEquals(row == col ? dd::COMPLEX_ONE : dd::COMPLEX_ZERO));
+        }
+    }
+}
+
+TEST(DDPackageTest, DenseMatrixExport) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    dd::Controls const control{{1, 1}};
+    auto               gate = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, control, 0), dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2));
+    const auto         dim  = dd->stateDimension();
+
+    // export must not print anything
+    testing::internal::CaptureStdout();
+    const auto matrix     = dd->getMatrix(gate);
+    const auto parallel   = dd->getMatrix(gate, 4);
+    const auto vectorized = dd->getVectorizedMatrix(gate);
+    EXPECT_TRUE(testing::internal::GetCapturedStdout().empty());
+
+    ASSERT_EQ(matrix.size(), dim);
+    ASSERT_EQ(vectorized.size(), dim * dim);
+    EXPECT_EQ(matrix, parallel);
+    for (auto row = 0U; row < dim; ++row) {
+        ASSERT_EQ(matrix.at(row).size(), dim);
+        const auto reprI = dd->getReprOfIndex(row, dim);
+        for (auto col = 0U; col < dim; ++col) {
+            const auto reference = dd->getValueByPath(gate, reprI, dd->getReprOfIndex(col, dim));
+            EXPECT_NEAR(matrix.at(row).at(col).real(), reference.r, 1e-12);
+            EXPECT_NEAR(matrix.at(row).at(col).imag(), reference.i, 1e-12);
+        }
+    }
+
+    // identity subtrees are written as diagonal blocks
+    const auto identity = dd->getMatrix(dd->makeIdent(3), 2);
+    for (auto row = 0U; row < dim; ++row) {
+        for (auto col = 0U; col < dim; ++col) {
+            EXPECT_EQ(identity.at(row).at(col), (std::complex<dd::fp>{row == col ? 1. : 0., 0.}));
+        }
+    }
+
+    dd::CVec buffer(dim);
+    EXPECT_THROW(dd->getMatrix(gate, buffer.data(), buffer.size()), std::invalid_argument);
+}
+
+TEST(DDPackageTest, StateFromVector) {
+    auto dd = std::make_unique<dd::MDDPackage>(5, std::vector<std::size_t>{2, 3, 2, 5, 3});
+    const auto dim = dd->stateDimension();
+
+    // random state with a few pruned amplitudes
+    std::mt19937_64                        gen(42); // NOLINT(cert-msc51-cpp): seed the generator with fixed value for reproducibility
+    std::normal_distribution<dd::fp>       distribution(0., 1.);
+    dd::CVec                               amplitudes(dim);
+    dd::fp                                 norm = 0.;
+    for (auto i = 0U; i < dim; ++i) {
+        amplitudes.at(i) = i % 7 == 3 ? std::complex<dd::fp>{1e-15, 0.} : std::complex<dd::fp>{distribution(gen), distribution(gen)};
+        norm += std::norm(amplitudes.at(i));
+    }
+    for (auto& amplitude: amplitudes) {
+        amplitude /= std::sqrt(norm);
+    }
+
+    const auto state    = dd->makeStateFromVector(amplitudes);
+    const auto parallel = dd->makeStateFromVector(amplitudes, 4);
+    EXPECT_EQ(state, parallel);
+    const auto vector = dd->getVector(state);
+    for (auto i = 0U; i < dim; ++i) {
+        const auto expected = i % 7 == 3 ? std::complex<dd::fp>{0., 0.} : amplitudes.at(i);
+        EXPECT_NEAR(vector.at(i).real(), expected.real(), 1e-9);
+        EXPECT_NEAR(vector.at(i).imag(), expected.imag(), 1e-9);
+    }
+
+    // basis states share the nodes of the existing constructors
+    dd::CVec basis(dim, {0., 0.});
+    basis.at(1 + 2 * (2 + 3 * (1 + 2 * (4 + 5 * 1)))) = {1., 0.};
+    EXPECT_EQ(dd->makeStateFromVector(basis, 3), dd->makeBasisState(5, {1, 2, 1, 4, 1}));
+
+    EXPECT_EQ(dd->makeStateFromVector(dd::CVec(dim, {0., 0.}), 2), dd::MDDPackage::vEdge::zero);
+    EXPECT_THROW(dd->makeStateFromVector(dd::CVec(dim - 1)), std::invalid_argument);
+
+    // small states provide fewer blocks than requested for the threads
+    auto           small = std::make_unique<dd::MDDPackage>(2, std::vector<std::size_t>{2, 3});
+    const dd::CVec smallAmplitudes{{0.5, 0.}, {0., 0.}, {0., 0.5}, {0.5, 0.}, {0., 0.}, {0., -0.5}};
+    const auto     sequential = small->makeStateFromVector(smallAmplitudes);
+    for (const auto threads: {2U, 4U, 16U}) {
+        EXPECT_EQ(small->makeStateFromVector(smallAmplitudes, threads), sequential);
+    }
+    const auto smallVector = small->getVector(sequential);
+    for (auto i = 0U; i < smallAmplitudes.size(); ++i) {
+        EXPECT_NEAR(std::abs(smallVector.at(i) - smallAmplitudes.at(i)), 0., 1e-12);
+    }
+}
+
+TEST(DDPackageTest, MatrixFromDenseAndSparse) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 5});
+
+    dd::Controls const control{{1, 1}};
+    const auto         gate = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, control, 0), dd->makeGateDD<dd::QuintMatrix>(dd::H5(), 3, 2));
+    const auto         dim  = dd->stateDimension();
+    dd::CVec           dense(dim * dim);
+    dd->getMatrix(gate, dense.data(), dense.size());
+
+    // dense import reuses the nodes of the gate
+    EXPECT_EQ(dd->makeDDFromMatrix(dense.data(), dense.size()), gate);
+
+    // the same operator in CSR and in COO format with every entry split into two summands in reverse order
+    dd::CSRMatrix csr{dim, {0}, {}, {}};
+    dd::COOMatrix coo{dim, {}, {}, {}};
+    for (auto row = 0U; row < dim; ++row) {
+        for (auto col = 0U; col < dim; ++col) {
+            const auto& value = dense.at(row * dim + col);
+            if (std::abs(value) > 1e-12) {
+                csr.columnIndices.push_back(col);
+                csr.values.push_back(value);
+                for (const auto part: {0.25, 0.75}) {
+                    coo.rows.push_back(row);
+                    coo.columns.push_back(col);
+                    coo.values.push_back(part * value);
+                }
+            }
+        }
+        csr.rowPointers.push_back(csr.values.size());
+    }
+    std::reverse(coo.rows.begin(), coo.rows.end());
+    std::reverse(coo.columns.begin(), coo.columns.end());
+    std::reverse(coo.values.begin(), coo.values.end());
+    EXPECT_EQ(dd->makeDDFromMatrix(csr), gate);
+    EXPECT_EQ(dd->makeDDFromMatrix(coo), gate);
+
+    // a tridiagonal hopping Hamiltonian that is no product of gates
+    dd::COOMatrix hamiltonian{dim, {}, {}, {}};
+    for (auto i = 0U; i + 1 < dim; ++i) {
+        hamiltonian.rows.insert(hamiltonian.rows.end(), {i, i + 1});
+        hamiltonian.columns.insert(hamiltonian.columns.end(), {i + 1, i});
+        hamiltonian.values.insert(hamiltonian.values.end(), {{-1., 0.5}, {-1., -0.5}});
+    }
+    dd::CMat expected(dim, dd::CVec(dim, {0., 0.}));
+    for (auto i = 0U; i + 1 < dim; ++i) {
+        expected.at(i).at(i + 1) = {-1., 0.5};
+        expected.at(i + 1).at(i) = {-1., -0.5};
+    }
+    expectMatricesNear(dd->getMatrix(dd->makeDDFromMatrix(hamiltonian)), expected);
+
+    EXPECT_EQ(dd->makeDDFromMatrix(dd::COOMatrix{dim, {}, {}, {}}), dd::MDDPackage::mEdge::zero);
+    EXPECT_THROW(dd->makeDDFromMatrix(dd::COOMatrix{dim, {dim}, {0}, {{1., 0.}}}), std::invalid_argument);
+    EXPECT_THROW(dd->makeDDFromMatrix(dd::CSRMatrix{dim, {0, 1}, {0}, {{1., 0.}}}), std::invalid_argument);
+    EXPECT_THROW(dd->makeDDFromMatrix(dd::COOMatrix{dim - 1, {}, {}, {}}), std::invalid_argument);
+    EXPECT_THROW(dd->makeDDFromMatrix(dense.data(), dim), std::invalid_argument);
+}
+
+TEST(DDPackageTest, TransposeAndAdjointMultiplication) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 4});
+    const auto dim = dd->stateDimension();
+
+    // the transpose agrees with the operator built from the entries with rows and columns exchanged
+    const auto operatorEntries = makeTestOperator(dim);
+    const auto a               = dd->makeDDFromMatrix(operatorEntries);
+    const auto transposed      = dd->makeDDFromMatrix(dd::COOMatrix{dim, operatorEntries.columns, operatorEntries.rows, operatorEntries.values});
+    expectMatricesNear(dd->getMatrix(dd->transpose(a)), dd->getMatrix(transposed));
+
+    dd::Controls const control{{0, 2}};
+    auto               u = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::RXY3(dd::PI_4, dd::PI_2, 0, 2), 3, 0),
+                                        dd->makeGateDD<dd::GateMatrix>(dd::Hmat, 3, control, 1));
+    u                    = dd->multiply(dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 0), u);
+    const auto psi       = dd->multiply(u, dd->makeBasisState(3, {1, 0, 3}));
+
+    // the products are computed in the compute tables of their own
+    const auto lookups  = dd->matrixMatrixMultiplication.getLookups();
+    const auto products = dd->multiplyAdjoint(a, u);
+    const auto state    = dd->multiplyAdjoint(a, psi);
+    EXPECT_EQ(dd->matrixMatrixMultiplication.getLookups(), lookups);
+    EXPECT_GT(dd->matrixMatrixAdjointMultiplication->getLookups(), 0U);
+    EXPECT_GT(dd->matrixVectorAdjointMultiplication->getLookups(), 0U);
+
+    const auto adjoint = dd->conjugateTranspose(a);
+    EXPECT_EQ(products, dd->multiply(adjoint, u));
+    EXPECT_EQ(state, dd->multiply(adjoint, psi));
+    expectMatricesNear(dd->getMatrix(products), dd->getMatrix(dd->multiply(adjoint, u)), 1e-10);
+
+    // uncomputation yields the identity and the initial state
+    EXPECT_EQ(dd->multiplyAdjoint(u, u), dd->makeIdent(3));
+    EXPECT_EQ(dd->multiplyAdjoint(u, psi), dd->makeBasisState(3, {1, 0, 3}));
+}
+
+TEST(DDPackageTest, SpecialMatrixFlags) {
+    auto dd = std::make_unique<dd::MDDPackage>(3, std::vector<std::size_t>{3, 2, 4});
+    const auto dim = dd->stateDimension();
+
+    const auto transposes = [&dd]() {
+        const auto& table = dd->matrixTranspose.getTable();
+        return std::count_if(table.begin(), table.end(), [](const auto& entry) { return entry.result.nextNode != nullptr; });
+    };
+
+    // creating nodes never transposes their successors
+    const auto operatorEntries = makeTestOperator(dim);
+    const auto a               = dd->makeDDFromMatrix(operatorEntries);
+    const auto h = dd->makeGateDD<dd::TritMatrix>(dd::H3(), 3, 0);
+    EXPECT_EQ(transposes(), 0);
+
+    EXPECT_TRUE(dd->makeIdent(3).nextNode->identity);
+    EXPECT_TRUE(dd->makeIdent(3).nextNode->symmetric);
+    EXPECT_FALSE(h.nextNode->identity);
+    EXPECT_TRUE(h.nextNode->symmetric);
+    EXPECT_FALSE(a.nextNode->symmetric);
+    EXPECT_EQ(dd->transpose(h), h);
+
+    // flags that cannot be derived without building a DD are conservative, the transpose stays correct
+    const auto at        = dd->transpose(a);
+    const auto symmetric = dd->add(a, at);
+    EXPECT_TRUE(dd->add(at, a) == symmetric);
+    auto symmetricEntries = operatorEntries;
+    symmetricEntries.rows.insert(symmetricEntries.rows.end(), operatorEntries.columns.begin(), operatorEntries.columns.end());
+    symmetricEntries.columns.insert(symmetricEntries.columns.end(), operatorEntries.rows.begin(), operatorEntries.rows.end());
+    symmetricEntries.values.insert(symmetricEntries.values.end(), operatorEntries.values.begin(), operatorEntries.values.end());
+    const auto dense = dd->getMatrix(dd->makeDDFromMatrix(symmetricEntries));
+    expectMatricesNear(dd->getMatrix(symmetric), dense);
+    expectMatricesNear(dd->getMatrix(dd->transpose(symmetric)), dense);
+}
+
+TEST(DDPackageTest, DynamicReordering) {
+    auto dd = std::make_unique<dd::MDDPackage>(4, std::vector<std::size_t>{2, 3, 2, 3});
+    const auto dim = dd->stateDimension();
+
+    // registers 0 and 2 as well as 1 and 3 are entangled, i.e., the order 0, 2, 1, 3 is the better one
+    const auto amplitude = [](const std::vector<std::size_t>& digits) {
+        if (digits.at(0) != digits.at(2) || digits.at(1) != digits.at(3)) {
+            return std::complex<dd::fp>{0., 0.};
+        }
+        return std::complex<dd::fp>{static_cast<dd::fp>(1 + digits.at(1)), static_cast<dd::fp>(digits.at(0))} / std::sqrt(dd::fp{30.});
+    };
+    dd::CVec amplitudes(dim);
+    for (auto i = 0U; i < dim; ++i) {
+        amplitudes.at(i) = amplitude({i % 2, (i / 2) % 3, (i / 6) % 2, i / 12});
+    }
+    // amplitudes of a DD in the current order compared to the ones of the logical registers
+    const auto checkState = [&dd, &amplitude, dim](const dd::MDDPackage::vEdge& state) {
+        const auto vector = dd->getVector(state);
+        const auto sizes  = dd->regsSize();
+        for (auto i = 0U; i < dim; ++i) {
+            std::vector<std::size_t> digits(sizes.size());
+            std::size_t              index = i;
+            for (auto level = 0U; level < sizes.size(); ++level) {
+                digits.at(static_cast<std::size_t>(dd->logicalRegister(static_cast<dd::QuantumRegister>(level)))) = index % sizes.at(level);
+                index /= sizes.at(level);
+            }
+            EXPECT_NEAR(std::abs(vector.at(i) - amplitude(digits)), 0., 1e-12);
+        }
+    };
+
+    const auto                         psi = dd->makeStateFromVector(amplitudes);
+    const auto                         a   = dd->makeDDFromMatrix(makeTestOperator(dim));
+    std::vector<dd::MDDPackage::vEdge> states{psi, dd->multiply(a, psi)};
+    std::vector<dd::MDDPackage::mEdge> operators{a, dd->makeIdent(4)};
+    const auto                         initialNodes = dd->nodeCount({psi}, {});
+
+    dd->swapLevels(1, states, operators);
+    EXPECT_EQ(dd->regsSize(), (std::vector<std::size_t>{2, 2, 3, 3}));
+    EXPECT_EQ(dd->logicalRegister(1), 2);
+    EXPECT_EQ(dd->physicalRegister(1), 2);
+    EXPECT_EQ(dd->physicalControls({{1, 2}}), (dd::Controls{{2, 2}}));
+    EXPECT_LT(dd->nodeCount({states.front()}, {}), initialNodes);
+    checkState(states.front());
+    EXPECT_EQ(dd->multiply(operators.front(), states.front()), states.back());
+    EXPECT_EQ(operators.back(), dd->makeIdent(4));
+
+    // swapping back restores the original DDs
+    dd->swapLevels(1, states, operators);
+    EXPECT_EQ(states.front(), psi);
+    EXPECT_EQ(operators.front(), a);
+    EXPECT_THROW(dd->swapLevels(3, states, operators), std::invalid_argument);
+
+    // sifting finds an order with adjacent entangled registers
+    std::vector<dd::MDDPackage::vEdge> sifted{psi};
+    const auto                         siftedNodes = dd->sift(sifted);
+    EXPECT_LT(siftedNodes, initialNodes);
+    EXPECT_EQ(siftedNodes, dd->nodeCount(sifted, {}));
+    checkState(sifted.front());
+
+
+    // automatic reordering runs once the threshold is crossed
+    std::vector<dd::MDDPackage::vEdge> automatic{sifted.front()};
+    EXPECT_FALSE(dd->reorderIfNeeded(automatic));
+    dd->setReorderingSettings({1, 2., 1.2});
+    EXPECT_TRUE(dd->reorderIfNeeded(automatic));
+    EXPECT_FALSE(dd->reorderIfNeeded(automatic));
+    checkState(automatic.front());
+    EXPECT_THROW(dd->setReorderingSettings({1, 0.5, 1.2}), std::invalid_argument);
+
+    // the node count tracked across the swaps matches the DDs left behind
+    std::vector<dd::MDDPackage::mEdge> identity{dd->makeIdent(4)};
+    EXPECT_EQ(dd->sift(automatic, identity), dd->nodeCount(automatic, identity));
+    checkState(automatic.front());
+}